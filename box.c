@@ -0,0 +1,250 @@
+#include "box.h"
+
+#include <isl/map.h>
+#include <isl/union_map.h>
+#include <isl/val.h>
+
+//+/////////////// boxes
+static void ciss_box_init(ciss_box* box) {
+  box->computed = 0;
+  box->empty = 0;
+  box->nb_dims = 0;
+  box->lower = NULL;
+  box->upper = NULL;
+}
+
+static void ciss_box_clear(ciss_box* box) {
+  free(box->lower);
+  free(box->upper);
+  ciss_box_init(box);
+}
+
+// Bound of a dimension, the given infinity if it is unbounded or rational.
+static int64_t ciss_box_bound(__isl_take isl_val* val, int64_t infinity) {
+  int64_t bound = infinity;
+  if (val != NULL && isl_val_is_int(val))
+    bound = (int64_t) isl_val_get_num_si(val);
+  isl_val_free(val);
+  return bound;
+}
+
+// Extends the box to contain the set.  Sets of another dimensionality make the
+// box unbounded.
+static int ciss_box_extend(__isl_take isl_set* set, void* usr) {
+  ciss_box* box = (ciss_box*) usr;
+  size_t nb_dims = (size_t) isl_set_dim(set, isl_dim_set);
+  size_t i;
+
+  if (box->empty) {
+    box->empty = 0;
+    box->nb_dims = nb_dims;
+    box->lower = (int64_t*) malloc(sizeof(int64_t) * (nb_dims + 1));
+    box->upper = (int64_t*) malloc(sizeof(int64_t) * (nb_dims + 1));
+    for (i = 0; i < nb_dims; i++) {
+      box->lower[i] = INT64_MAX;
+      box->upper[i] = INT64_MIN;
+    }
+  }
+
+  for (i = 0; i < box->nb_dims; i++) {
+    int64_t lower = INT64_MIN, upper = INT64_MAX;
+    if (nb_dims == box->nb_dims) {
+      lower = ciss_box_bound(isl_set_dim_min_val(isl_set_copy(set), (int) i), INT64_MIN);
+      upper = ciss_box_bound(isl_set_dim_max_val(isl_set_copy(set), (int) i), INT64_MAX);
+    }
+    box->lower[i] = lower < box->lower[i] ? lower : box->lower[i];
+    box->upper[i] = upper > box->upper[i] ? upper : box->upper[i];
+  }
+  isl_set_free(set);
+  return 0;
+}
+
+static void ciss_box_compute(ciss_box* box, __isl_take isl_union_set* uset) {
+  box->computed = 1;
+  box->empty = 1;
+  isl_union_set_foreach_set(uset, &ciss_box_extend, box);
+  isl_union_set_free(uset);
+}
+
+// Collects the differences between the range and the domain points of the
+// maps.  Drops them all if some map has different dimensionality in domain
+// and range, differences are then unknown.
+static int ciss_box_deltas(__isl_take isl_map* map, void* usr) {
+  isl_union_set** deltas = (isl_union_set**) usr;
+  if (*deltas == NULL || isl_map_dim(map, isl_dim_in) != isl_map_dim(map, isl_dim_out)) {
+    isl_union_set_free(*deltas);
+    *deltas = NULL;
+    isl_map_free(map);
+    return 0;
+  }
+  map = isl_map_reset_tuple_id(map, isl_dim_in);
+  map = isl_map_reset_tuple_id(map, isl_dim_out);
+  *deltas = isl_union_set_add_set(*deltas, isl_map_deltas(map));
+  return 0;
+}
+
+// Sum of bounds, unbounded if either of them is.
+static int64_t ciss_box_add(int64_t bound, int64_t delta, int64_t infinity) {
+  if (bound == infinity || delta == infinity)
+    return infinity;
+  if (delta > 0 && bound > INT64_MAX - delta)
+    return INT64_MAX;
+  if (delta < 0 && bound < INT64_MIN - delta)
+    return INT64_MIN;
+  return bound + delta;
+}
+
+//+/////////////// filter
+ciss_box_filter* ciss_box_filter_create(ciss_graph* graph, ciss_statement_index* statements) {
+  ciss_box_filter* filter = (ciss_box_filter*) malloc(sizeof(ciss_box_filter));
+  size_t i;
+
+  filter->statements = statements;
+  filter->nb_arcs = graph->nb_arcs;
+  filter->arc_domains = (ciss_box*) malloc(sizeof(ciss_box) * (filter->nb_arcs + 1));
+  filter->arc_ranges = (ciss_box*) malloc(sizeof(ciss_box) * (filter->nb_arcs + 1));
+  filter->arc_deltas = (ciss_box*) malloc(sizeof(ciss_box) * (filter->nb_arcs + 1));
+  for (i = 0; i < filter->nb_arcs; i++) {
+    ciss_box_init(&filter->arc_domains[i]);
+    ciss_box_init(&filter->arc_ranges[i]);
+    ciss_box_init(&filter->arc_deltas[i]);
+  }
+  filter->domains = (ciss_box*) malloc(sizeof(ciss_box) * (statements->nb_statements + 1));
+  for (i = 0; i < statements->nb_statements; i++) {
+    ciss_box_init(&filter->domains[i]);
+  }
+  filter->nb_scratch = 0;
+  filter->lower = NULL;
+  filter->upper = NULL;
+  filter->nb_passed = 0;
+  filter->nb_filtered = 0;
+  return filter;
+}
+
+void ciss_box_filter_destroy(ciss_box_filter* filter) {
+  size_t i;
+  if (filter == NULL)
+    return;
+  for (i = 0; i < filter->nb_arcs; i++) {
+    ciss_box_clear(&filter->arc_domains[i]);
+    ciss_box_clear(&filter->arc_ranges[i]);
+    ciss_box_clear(&filter->arc_deltas[i]);
+  }
+  for (i = 0; i < filter->statements->nb_statements; i++) {
+    ciss_box_clear(&filter->domains[i]);
+  }
+  free(filter->arc_domains);
+  free(filter->arc_ranges);
+  free(filter->arc_deltas);
+  free(filter->domains);
+  free(filter->lower);
+  free(filter->upper);
+  free(filter);
+}
+
+static ciss_box* ciss_box_filter_domain(ciss_box_filter* filter, ciss_statement* statement) {
+  ciss_box* box = &filter->domains[(size_t) statement->label];
+  if (!box->computed)
+    ciss_box_compute(box, isl_union_set_from_set(isl_set_copy(statement->domain_set)));
+  return box;
+}
+
+static void ciss_box_filter_arc(ciss_box_filter* filter, ciss_arc_cache* cache, ciss_graph_arc* arc) {
+  isl_union_map* umap;
+  isl_union_set* deltas;
+  if (filter->arc_domains[arc->id].computed)
+    return;
+  umap = ciss_arc_cache_get(cache, cache->ctx, arc);
+  deltas = isl_union_set_empty(isl_union_map_get_space(umap));
+  isl_union_map_foreach_map(umap, &ciss_box_deltas, &deltas);
+  if (deltas != NULL)
+    ciss_box_compute(&filter->arc_deltas[arc->id], deltas);
+  else
+    filter->arc_deltas[arc->id].computed = 1;
+  ciss_box_compute(&filter->arc_domains[arc->id], isl_union_map_domain(isl_union_map_copy(umap)));
+  ciss_box_compute(&filter->arc_ranges[arc->id], isl_union_map_range(umap));
+}
+
+// Starts propagation from the box, returns 0 if it is empty.
+static int ciss_box_filter_start(ciss_box_filter* filter, ciss_box* box) {
+  size_t i;
+  if (box->empty)
+    return 0;
+  if (box->nb_dims > filter->nb_scratch) {
+    filter->nb_scratch = box->nb_dims;
+    filter->lower = (int64_t*) realloc(filter->lower, sizeof(int64_t) * filter->nb_scratch);
+    filter->upper = (int64_t*) realloc(filter->upper, sizeof(int64_t) * filter->nb_scratch);
+  }
+  for (i = 0; i < box->nb_dims; i++) {
+    filter->lower[i] = box->lower[i];
+    filter->upper[i] = box->upper[i];
+  }
+  return 1;
+}
+
+// Intersects the propagated box with the given one, returns 0 if the result
+// is empty.  Boxes of different dimensionality are assumed to intersect.
+// The loop is branch-free so that it vectorizes.
+static int ciss_box_filter_intersect(ciss_box_filter* filter, ciss_box* box, size_t nb_dims) {
+  int64_t* restrict lower = filter->lower;
+  int64_t* restrict upper = filter->upper;
+  const int64_t* restrict box_lower = box->lower;
+  const int64_t* restrict box_upper = box->upper;
+  int empty = 0;
+  size_t i;
+
+  if (box->empty)
+    return 0;
+  if (box->nb_dims != nb_dims)
+    return 1;
+  for (i = 0; i < nb_dims; i++) {
+    lower[i] = lower[i] > box_lower[i] ? lower[i] : box_lower[i];
+    upper[i] = upper[i] < box_upper[i] ? upper[i] : box_upper[i];
+    empty |= lower[i] > upper[i];
+  }
+  return !empty;
+}
+
+// Moves the propagated box through a relation whose range points lie within
+// the given differences from their domain points.
+static void ciss_box_filter_shift(ciss_box_filter* filter, ciss_box* deltas, size_t nb_dims) {
+  size_t i;
+  for (i = 0; i < nb_dims; i++) {
+    filter->lower[i] = ciss_box_add(filter->lower[i], deltas->lower[i], INT64_MIN);
+    filter->upper[i] = ciss_box_add(filter->upper[i], deltas->upper[i], INT64_MAX);
+  }
+}
+
+// Returns 0 if the image of the source domain along the path certainly misses
+// the target domain, in which case splitting by the path changes nothing.
+// The box of the source domain is intersected with the domain of each arc and
+// moved to its range.  Where the arc keeps the dimensionality, the box is
+// shifted by the differences between range and domain points and intersected
+// with the range.  Otherwise, the range box replaces it.
+int ciss_box_filter_path(ciss_box_filter* filter, ciss_arc_cache* cache,
+                         ciss_statement* source, ciss_statement* target, ciss_graph_path* path) {
+  ciss_box* box = ciss_box_filter_domain(filter, source);
+  size_t nb_dims = box->nb_dims;
+  int reaches = ciss_box_filter_start(filter, box);
+
+  for ( ; reaches && path != NULL; path = path->next) {
+    ciss_box* deltas = &filter->arc_deltas[path->arc->id];
+    ciss_box_filter_arc(filter, cache, path->arc);
+    reaches = ciss_box_filter_intersect(filter, &filter->arc_domains[path->arc->id], nb_dims);
+    box = &filter->arc_ranges[path->arc->id];
+    if (deltas->nb_dims == nb_dims && box->nb_dims == nb_dims && !deltas->empty) {
+      ciss_box_filter_shift(filter, deltas, nb_dims);
+      reaches = reaches && ciss_box_filter_intersect(filter, box, nb_dims);
+    } else {
+      nb_dims = box->nb_dims;
+      reaches = reaches && !deltas->empty && ciss_box_filter_start(filter, box);
+    }
+  }
+  reaches = reaches && ciss_box_filter_intersect(filter, ciss_box_filter_domain(filter, target), nb_dims);
+
+  if (reaches)
+    filter->nb_passed++;
+  else
+    filter->nb_filtered++;
+  return reaches;
+}
@@ -0,0 +1,48 @@
+#ifndef BOX_H
+#define BOX_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <isl/set.h>
+#include <isl/union_set.h>
+
+#include "cache.h"
+#include "graph.h"
+#include "path.h"
+#include "statement.h"
+
+// Interval over-approximation of a set, valid for all parameter values.
+// Unbounded sides are INT64_MIN and INT64_MAX.
+typedef struct ciss_box {
+  int computed;
+  int empty;
+  size_t nb_dims;
+  int64_t* lower;
+  int64_t* upper;
+} ciss_box;
+
+// Boxes of statement domains and of arc domains and ranges, computed on first
+// use.  Filter has ownership of the boxes, but not of the statements.
+typedef struct ciss_box_filter {
+  ciss_statement_index* statements;
+  size_t nb_arcs;
+  ciss_box* arc_domains;  // By arc identifier.
+  ciss_box* arc_ranges;
+  ciss_box* arc_deltas;   // Range minus domain points, no dimensions if they
+                          // have different dimensionality.
+  ciss_box* domains;      // By statement label.
+  size_t nb_scratch;
+  int64_t* lower;         // Box propagated along a path.
+  int64_t* upper;
+  size_t nb_passed;       // Paths that may split their target.
+  size_t nb_filtered;     // Paths skipped without calling isl.
+} ciss_box_filter;
+
+ciss_box_filter* ciss_box_filter_create(ciss_graph*, ciss_statement_index*);
+void ciss_box_filter_destroy(ciss_box_filter*);
+
+int ciss_box_filter_path(ciss_box_filter*, ciss_arc_cache*, ciss_statement*, ciss_statement*,
+                         ciss_graph_path*);
+
+#endif // BOX_H
@@ -0,0 +1,60 @@
+#include "cache.h"
+#include "convert.h"
+
+// The context may be NULL if the scop has none.
+ciss_arc_cache* ciss_arc_cache_create(isl_ctx* ctx, ciss_graph* graph, isl_set* context) {
+  ciss_arc_cache* cache = (ciss_arc_cache*) malloc(sizeof(ciss_arc_cache));
+  cache->ctx = ctx;
+  cache->context = context != NULL ? isl_set_copy(context) : NULL;
+  cache->nb_arcs = graph->nb_arcs;
+  cache->maps = (isl_union_map**) calloc(cache->nb_arcs + 1, sizeof(isl_union_map*));
+  return cache;
+}
+
+void ciss_arc_cache_destroy(ciss_arc_cache* cache) {
+  size_t i;
+  if (cache == NULL)
+    return;
+  for (i = 0; i < cache->nb_arcs; i++) {
+    isl_union_map_free(cache->maps[i]);
+  }
+  isl_set_free(cache->context);
+  free(cache->maps);
+  free(cache);
+}
+
+// Union of the relations of all dependences of the arc.
+static __isl_give isl_union_map* ciss_arc_to_isl_union_map(isl_ctx* ctx, ciss_graph_arc* arc) {
+  isl_union_map* umap = osl_dependence_to_isl_union_map(ctx, arc->dependence);
+  ciss_graph_dependence_list* merged;
+  for (merged = arc->merged; merged != NULL; merged = merged->next) {
+    umap = isl_union_map_union(umap, osl_dependence_to_isl_union_map(ctx, merged->dependence));
+  }
+  return umap;
+}
+
+// Returns a copy of the cached relation, or converts the dependences in the
+// given context if there is no cache.
+__isl_give isl_union_map* ciss_arc_cache_get(ciss_arc_cache* cache, isl_ctx* ctx, ciss_graph_arc* arc) {
+  isl_union_map* umap;
+  if (cache == NULL || arc->id >= cache->nb_arcs)
+    return ciss_arc_to_isl_union_map(ctx, arc);
+
+  if (cache->maps[arc->id] == NULL) {
+    umap = ciss_arc_to_isl_union_map(cache->ctx, arc);
+    if (cache->context != NULL)
+      umap = isl_union_map_intersect_params(umap, isl_set_copy(cache->context));
+    cache->maps[arc->id] = isl_union_map_coalesce(umap);
+  }
+  return isl_union_map_copy(cache->maps[arc->id]);
+}
+
+// Reuses the relation of an arc carrying the same dependences in a previous
+// cache.  Both caches must share the isl context and the scop context.
+void ciss_arc_cache_adopt(ciss_arc_cache* cache, ciss_graph_arc* arc,
+                          ciss_arc_cache* previous, ciss_graph_arc* previous_arc) {
+  if (arc->id >= cache->nb_arcs || cache->maps[arc->id] != NULL ||
+      previous_arc->id >= previous->nb_arcs || previous->maps[previous_arc->id] == NULL)
+    return;
+  cache->maps[arc->id] = isl_union_map_copy(previous->maps[previous_arc->id]);
+}
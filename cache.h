@@ -0,0 +1,28 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdlib.h>
+
+#include <isl/ctx.h>
+#include <isl/set.h>
+#include <isl/union_map.h>
+
+#include "graph.h"
+
+// Dependence relations of the graph arcs by arc identifier, converted and
+// restricted to the scop context once.  Cache has ownership of the relations
+// and of its copy of the context.
+typedef struct ciss_arc_cache {
+  isl_ctx* ctx;
+  isl_set* context;
+  size_t nb_arcs;
+  isl_union_map** maps;
+} ciss_arc_cache;
+
+ciss_arc_cache* ciss_arc_cache_create(isl_ctx*, ciss_graph*, __isl_keep isl_set*);
+void ciss_arc_cache_destroy(ciss_arc_cache*);
+
+__isl_give isl_union_map* ciss_arc_cache_get(ciss_arc_cache*, isl_ctx*, ciss_graph_arc*);
+void ciss_arc_cache_adopt(ciss_arc_cache*, ciss_graph_arc*, ciss_arc_cache*, ciss_graph_arc*);
+
+#endif // CACHE_H
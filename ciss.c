@@ -0,0 +1,1074 @@
+#include <osl/osl.h>
+#include <osl/extensions/dependence.h>
+
+#include <candl/candl.h>
+#include <candl/dependence.h>
+
+#include <isl/ctx.h>
+#include <isl/set.h>
+#include <isl/map.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ciss.h"
+#include "convert.h"
+#include "kleene.h"
+#include "linked_list.h"
+#include "trace.h"
+
+// isl relation processing
+// The arc cache may be NULL, relations are then converted in the given context.
+isl_union_map* ciss_relation_compose_list_isl(ciss_graph_path* path, isl_ctx *ctx, ciss_arc_cache* cache) {
+  isl_union_map* composed_umap = NULL;
+
+  for ( ; path != NULL; path = path->next) {
+    double start = ciss_trace_now();
+    isl_union_map* dependence_umap = ciss_arc_cache_get(cache, ctx, path->arc);
+
+    if (composed_umap == NULL) {
+      composed_umap = dependence_umap;
+    } else {
+      composed_umap = isl_union_map_apply_range(composed_umap, dependence_umap);
+    }
+    ciss_trace_span_relation("compose", start, composed_umap,
+                             "\"arc\": %zu, \"source\": %d, \"target\": %d",
+                             path->arc->id, path->arc->source->label, path->arc->target->label);
+  }
+
+  return composed_umap;
+}
+
+osl_relation_p ciss_relation_compose_list(ciss_graph_path* path) {
+  osl_relation_p relation;
+  isl_ctx *ctx = isl_ctx_alloc();
+
+  isl_union_map* composed_umap = ciss_relation_compose_list_isl(path, ctx, NULL);
+
+  relation = isl_union_map_to_osl_relation(composed_umap);
+  isl_ctx_free(ctx);
+  return relation;
+}
+
+// Combines the relations of the operands of a sequence, alternative or
+// closure element, operands are evaluated by the callback.  NULL stands for
+// the empty relation.
+static __isl_give isl_union_map* ciss_relation_compose_kleene_operands(
+    isl_ctx* ctx, ciss_kleene_element* head,
+    __isl_give isl_union_map* (*operand)(isl_ctx*, ciss_kleene_element*, void*), void* user) {
+  isl_union_map* composed_umap = NULL;
+  int exact;
+  ciss_kleene_element_list* list_element;
+
+  switch (head->type) {
+  case LIST_SEQUENCE:
+    for (list_element = head->list; list_element != NULL; list_element = list_element->next) {
+      if (list_element->element->type == EPSILON)
+        continue;
+      isl_union_map* recurse_map = operand(ctx, list_element->element, user);
+      if (recurse_map == NULL) {
+        isl_union_map_free(composed_umap);
+        composed_umap = NULL;
+        break;
+      }
+      if (composed_umap == NULL) {
+        composed_umap = recurse_map;
+      } else if (list_element->element->type == STAR) {
+        // Closure inside a sequence also accounts for zero iterations.
+        isl_union_map* iterated_umap = isl_union_map_apply_range(isl_union_map_copy(composed_umap), recurse_map);
+        composed_umap = isl_union_map_union(composed_umap, iterated_umap);
+      } else {
+        composed_umap = isl_union_map_apply_range(composed_umap, recurse_map);
+      }
+    }
+    break;
+  case LIST_ALTERNATIVES:
+    for (list_element = head->list; list_element != NULL; list_element = list_element->next) {
+      isl_union_map* recurse_map = operand(ctx, list_element->element, user);
+      if (recurse_map == NULL)
+        continue;
+      if (composed_umap == NULL)
+        composed_umap = recurse_map;
+      else
+        composed_umap = isl_union_map_union(composed_umap, recurse_map);
+    }
+    break;
+  case STAR:
+    composed_umap = operand(ctx, head->star, user);
+    if (composed_umap != NULL) {
+      double start = ciss_trace_now();
+      composed_umap = isl_union_map_transitive_closure(composed_umap, &exact);
+      ciss_trace_span_relation("closure", start, composed_umap, "\"exact\": %d", exact);
+    }
+    break;
+  default:
+    break;
+  }
+  return composed_umap;
+}
+
+static __isl_give isl_union_map* ciss_relation_compose_kleene_operand(isl_ctx* ctx,
+                                                                      ciss_kleene_element* element,
+                                                                      void* cache) {
+  return ciss_relation_compose_kleene_recurse(ctx, (ciss_arc_cache*) cache, element);
+}
+
+isl_union_map* ciss_relation_compose_kleene_recurse(isl_ctx* ctx, ciss_arc_cache* cache, ciss_kleene_element* head) {
+  switch (head->type) {
+  case SINGLE:
+    return ciss_arc_cache_get(cache, ctx, head->arc);
+  case EMPTY:
+    return NULL;
+  case EPSILON:
+    return osl_relation_to_isl_union_map(ctx, head->node->domain_ptr);
+  default:
+    return ciss_relation_compose_kleene_operands(ctx, head, ciss_relation_compose_kleene_operand, cache);
+  }
+}
+
+osl_relation_p ciss_relation_compose_kleene(ciss_kleene_element* head) {
+  isl_ctx *ctx = isl_ctx_alloc();
+  osl_relation_p relation =
+      isl_union_map_to_osl_relation(ciss_relation_compose_kleene_recurse(ctx, NULL, head));
+  isl_ctx_free(ctx);
+  return relation;
+}
+
+//+/////////////// parallel composition
+// Every composite element of the path expressions is evaluated once, by a task
+// depending on the tasks of its composite operands.  Workers have their own
+// isl contexts, so relations are passed between tasks in isl textual form.
+typedef struct ciss_kleene_task {
+  ciss_task task;
+  ciss_kleene_element* element;
+  struct ciss_kleene_evaluation* evaluation;
+  char* result;  // NULL for the empty relation.
+} ciss_kleene_task;
+
+typedef struct ciss_kleene_evaluation {
+  size_t nb_tasks;
+  ciss_kleene_task* tasks;
+  ciss_kleene_task** sorted;  // Tasks sorted by element address.
+  size_t nb_arcs;
+  char** arcs;  // Relations of the arcs used by the tasks, by arc identifier.
+} ciss_kleene_evaluation;
+
+static int ciss_kleene_task_compare(const void* a, const void* b) {
+  uintptr_t element_a = (uintptr_t) (*(ciss_kleene_task* const*) a)->element;
+  uintptr_t element_b = (uintptr_t) (*(ciss_kleene_task* const*) b)->element;
+  return (element_a > element_b) - (element_a < element_b);
+}
+
+static ciss_kleene_task* ciss_kleene_evaluation_find(ciss_kleene_evaluation* evaluation,
+                                                     ciss_kleene_element* element) {
+  ciss_kleene_task key;
+  ciss_kleene_task* key_ptr = &key;
+  ciss_kleene_task** found;
+  key.element = element;
+  found = (ciss_kleene_task**) bsearch(&key_ptr, evaluation->sorted, evaluation->nb_tasks,
+                                       sizeof(ciss_kleene_task*), ciss_kleene_task_compare);
+  return found != NULL ? *found : NULL;
+}
+
+static __isl_give isl_union_map* ciss_kleene_task_operand(isl_ctx* ctx,
+                                                          ciss_kleene_element* element,
+                                                          void* user) {
+  ciss_kleene_evaluation* evaluation = (ciss_kleene_evaluation*) user;
+  const char* str;
+  switch (element->type) {
+  case SINGLE:
+    str = evaluation->arcs[element->arc->id];
+    break;
+  case EMPTY:
+    return NULL;
+  case EPSILON:
+    return osl_relation_to_isl_union_map(ctx, element->node->domain_ptr);
+  default:
+    str = ciss_kleene_evaluation_find(evaluation, element)->result;
+    break;
+  }
+  return str != NULL ? isl_union_map_read_from_str(ctx, str) : NULL;
+}
+
+static void ciss_kleene_task_run(ciss_task* task, isl_ctx* ctx) {
+  ciss_kleene_task* kleene_task = (ciss_kleene_task*) task->data;
+  isl_union_map* umap = ciss_relation_compose_kleene_operands(ctx, kleene_task->element,
+                                                              ciss_kleene_task_operand,
+                                                              kleene_task->evaluation);
+  if (umap != NULL) {
+    kleene_task->result = isl_union_map_to_str(umap);
+    isl_union_map_free(umap);
+  }
+}
+
+// Serializes the cached relation of an arc operand, and makes the task depend
+// on the task of a composite operand.
+static void ciss_kleene_evaluation_operand(ciss_kleene_evaluation* evaluation,
+                                           ciss_arc_cache* cache,
+                                           ciss_kleene_task* task,
+                                           ciss_kleene_element* operand) {
+  isl_union_map* umap;
+  switch (operand->type) {
+  case SINGLE:
+    if (evaluation->arcs[operand->arc->id] == NULL) {
+      umap = ciss_arc_cache_get(cache, cache->ctx, operand->arc);
+      evaluation->arcs[operand->arc->id] = isl_union_map_to_str(umap);
+      isl_union_map_free(umap);
+    }
+    break;
+  case LIST_SEQUENCE:
+  case LIST_ALTERNATIVES:
+  case STAR:
+    ciss_task_depends(&task->task, &ciss_kleene_evaluation_find(evaluation, operand)->task);
+    break;
+  default:
+    break;
+  }
+}
+
+// Evaluates the path expressions of all queries on the pool.  Returns their
+// relations in the context of the cache and in query order, NULL for empty
+// ones.  The caller frees the array.
+isl_union_map** ciss_relation_compose_kleene_parallel(ciss_pool* pool,
+                                                      ciss_arc_cache* cache,
+                                                      ciss_kleene_query* queries) {
+  ciss_kleene_evaluation evaluation;
+  ciss_kleene_element** elements;
+  ciss_kleene_element_list* iter;
+  ciss_kleene_query* query;
+  ciss_task** tasks;
+  isl_union_map** results;
+  size_t i, nb_queries = 0;
+
+  elements = ciss_kleene_query_elements(queries, &evaluation.nb_tasks);
+  evaluation.tasks = (ciss_kleene_task*) malloc(sizeof(ciss_kleene_task) * (evaluation.nb_tasks + 1));
+  evaluation.sorted = (ciss_kleene_task**) malloc(sizeof(ciss_kleene_task*) * (evaluation.nb_tasks + 1));
+  tasks = (ciss_task**) malloc(sizeof(ciss_task*) * (evaluation.nb_tasks + 1));
+  evaluation.nb_arcs = cache->nb_arcs;
+  evaluation.arcs = (char**) calloc(evaluation.nb_arcs + 1, sizeof(char*));
+  for (i = 0; i < evaluation.nb_tasks; i++) {
+    ciss_kleene_task* task = &evaluation.tasks[i];
+    ciss_task_init(&task->task, ciss_kleene_task_run, task);
+    task->element = elements[i];
+    task->evaluation = &evaluation;
+    task->result = NULL;
+    evaluation.sorted[i] = task;
+    tasks[i] = &task->task;
+  }
+  qsort(evaluation.sorted, evaluation.nb_tasks, sizeof(ciss_kleene_task*), ciss_kleene_task_compare);
+
+  // Everything touching the cache happens here, on the calling thread.
+  for (i = 0; i < evaluation.nb_tasks; i++) {
+    ciss_kleene_task* task = &evaluation.tasks[i];
+    if (task->element->type == STAR) {
+      ciss_kleene_evaluation_operand(&evaluation, cache, task, task->element->star);
+    } else {
+      for (iter = task->element->list; iter != NULL; iter = iter->next) {
+        ciss_kleene_evaluation_operand(&evaluation, cache, task, iter->element);
+      }
+    }
+  }
+
+  ciss_pool_run(pool, tasks, evaluation.nb_tasks);
+
+  for (query = queries; query != NULL; query = query->next)
+    nb_queries++;
+  results = (isl_union_map**) malloc(sizeof(isl_union_map*) * (nb_queries + 1));
+  for (query = queries, i = 0; query != NULL; query = query->next, i++) {
+    ciss_kleene_task* task;
+    if (query->element == NULL) {
+      results[i] = NULL;
+    } else if ((task = ciss_kleene_evaluation_find(&evaluation, query->element)) != NULL) {
+      results[i] = task->result != NULL ? isl_union_map_read_from_str(cache->ctx, task->result) : NULL;
+    } else {
+      results[i] = ciss_relation_compose_kleene_recurse(cache->ctx, cache, query->element);
+    }
+  }
+
+  for (i = 0; i < evaluation.nb_tasks; i++) {
+    free(evaluation.tasks[i].result);
+    ciss_task_clear(&evaluation.tasks[i].task);
+  }
+  for (i = 0; i < evaluation.nb_arcs; i++) {
+    free(evaluation.arcs[i]);
+  }
+  free(evaluation.arcs);
+  free(tasks);
+  free(evaluation.sorted);
+  free(evaluation.tasks);
+  free(elements);
+  return results;
+}
+
+// Complex algorithms on graphs
+// Only reports paths ending in one of the targets and does not follow arcs
+// from which no target can be reached, unless targets are NULL.
+void ciss_dfs_pu_recurse(ciss_graph_node* node,
+                         ciss_graph_path* path,
+                         ciss_reachability* reach,
+                         const uint64_t* targets,
+                         void (*callback)(ciss_graph_path*, void*),
+                         void* param) {
+  ciss_graph_arc* arc;
+  ciss_graph_path* newpath;
+  size_t arc_repetitions;
+
+  if (node == NULL)
+    return;
+
+  if (callback != NULL && path != NULL &&
+      (targets == NULL || ciss_reachability_set_contains(targets, ciss_reachability_index(reach, node))))
+    callback(path, param);
+
+  for (arc = node->outgoing; arc != NULL; arc = arc->next) {
+    if (targets != NULL) {
+      size_t next = ciss_reachability_index(reach, arc->target);
+      if (!ciss_reachability_set_contains(targets, next) &&
+          !ciss_reachability_row_intersects(reach, next, targets))
+        continue;
+    }
+    arc_repetitions = ciss_graph_path_count_arcs(path, arc);
+    if (arc_repetitions == 1)
+      continue;
+
+    newpath = ciss_graph_path_clone(path);
+    newpath = ciss_graph_path_append(newpath, arc);
+    ciss_dfs_pu_recurse(arc->target, newpath, reach, targets, callback, param);
+    ciss_graph_path_destroy(newpath);
+  }
+}
+
+// path-unique DFS
+void ciss_dfs_pu(ciss_graph_node* node,
+                 void (*callback)(ciss_graph_path*, void*),
+                 void* param) {
+  ciss_dfs_pu_recurse(node, NULL, NULL, NULL, callback, param);
+}
+
+void ciss_dfs_pu_targets(ciss_graph_node* node,
+                         ciss_reachability* reach,
+                         const uint64_t* targets,
+                         void (*callback)(ciss_graph_path*, void*),
+                         void* param) {
+  ciss_dfs_pu_recurse(node, NULL, reach, targets, callback, param);
+}
+
+// CISS_DEPENDENCE_* kind of an OpenScop dependence.
+int ciss_dependence_type(osl_dependence_p dependence) {
+  switch (dependence->type) {
+  case OSL_DEPENDENCE_RAW:
+  case OSL_DEPENDENCE_RAW_SCALPRIV:
+    return CISS_DEPENDENCE_RAW;
+  case OSL_DEPENDENCE_WAR:
+    return CISS_DEPENDENCE_WAR;
+  case OSL_DEPENDENCE_WAW:
+    return CISS_DEPENDENCE_WAW;
+  case OSL_DEPENDENCE_RAR:
+    return CISS_DEPENDENCE_RAR;
+  default:
+    return 0;
+  }
+}
+
+ciss_graph* ciss_graph_construct(osl_dependence_p dependence) {
+  return ciss_graph_construct_types(dependence, 0, 0);
+}
+
+// Only dependences of the given CISS_DEPENDENCE_* kinds become arcs, all if 0.
+// If merge is set, all dependences between two statements share one arc.
+ciss_graph* ciss_graph_construct_types(osl_dependence_p dependence, int types, int merge) {
+  ciss_graph* dependence_graph = ciss_graph_create();
+  for ( ; dependence != NULL; dependence = dependence->next) {
+    if (types != 0 && !(ciss_dependence_type(dependence) & types))
+      continue;
+    ciss_graph_node* source = ciss_graph_ensure_node(dependence_graph, dependence->label_source);
+    ciss_graph_node* target = ciss_graph_ensure_node(dependence_graph, dependence->label_target);
+    if (merge)
+      ciss_graph_connect_merge(dependence_graph, source, target, dependence);
+    else
+      ciss_graph_connect(dependence_graph, source, target, dependence);
+//    ciss_graph_arc* arc = ciss_graph_arc_create(source, target, dependence);
+//    ciss_graph_node_append_arc(source, arc);
+  }
+  return dependence_graph;
+}
+
+void ciss_collect_all_paths(ciss_graph_path_point* path, void* path_list) {
+  ciss_graph_path_list** list = (ciss_graph_path_list**) path_list;
+  *list = ciss_graph_path_list_append(*list, ciss_graph_path_clone(path));
+}
+
+ciss_graph_path_list* ciss_graph_all_paths(ciss_graph* graph) {
+  ciss_graph_path_list* list = NULL;
+  ciss_graph_node* node;
+  for (node = graph->nodes; node != NULL; node = node->next) {
+    ciss_dfs_pu(node, &ciss_collect_all_paths, &list);
+  }
+  return list;
+}
+
+static void ciss_store_path(ciss_graph_path_point* path, void* store) {
+  ciss_path_store_append((ciss_path_store*) store, path);
+}
+
+// Appends all paths ending in one of the targets to the store, nodes that reach
+// no target are skipped.
+void ciss_graph_store_paths_to(ciss_reachability* reach, const uint64_t* targets,
+                               ciss_path_store* store) {
+  size_t i;
+  for (i = 0; i < reach->nb_nodes; i++) {
+    if (targets != NULL && !ciss_reachability_row_intersects(reach, i, targets))
+      continue;
+    ciss_dfs_pu_targets(reach->nodes[i], reach, targets, &ciss_store_path, store);
+  }
+}
+
+void ciss_graph_path_list_print(ciss_graph_path_list* list) {
+  ciss_graph_path_list* l;
+  for (l = list; l != NULL; l = l->next) {
+    ciss_graph_path* path = l->path;
+    for (path = l->path; path != NULL; path = path->next) {
+      ciss_graph_arc* arc = path->arc;
+      printf("(%d -> %d)", arc->source->label, arc->target->label);
+    }
+    printf("\n");
+  }
+}
+
+// Splits the target domain by the image of the source domain, takes the dependence relation.
+// Pieces are computed within the scop context, constraints implied by it are
+// dropped from the resulting domains.
+void ciss_split_by_relation(ciss_arc_cache* cache,
+                            ciss_cost_model* model,
+                            ciss_statement* source,
+                            ciss_statement* target,
+                            isl_union_map* dependence_umap) {
+  double start = ciss_trace_now();
+  const char* outcome;
+  isl_union_set* source_domain_uset = isl_union_set_from_set(isl_set_copy(source->domain_set));
+  isl_union_set* dependence_uset = isl_union_set_apply(source_domain_uset, dependence_umap);
+  isl_union_map* target_domain_umap = osl_relation_to_isl_union_map(cache->ctx, target->domain);
+  isl_union_set* target_domain_uset = isl_union_map_range(target_domain_umap);
+  if (cache->context != NULL)
+    target_domain_uset = isl_union_set_intersect_params(target_domain_uset, isl_set_copy(cache->context));
+  isl_union_set* intersection = isl_union_set_intersect(dependence_uset, isl_union_set_copy(target_domain_uset));
+  // Coalescing could merge pieces of earlier splits back, it is only used to
+  // give equal images the same textual form.
+  isl_union_set* coalesced = isl_union_set_coalesce(isl_union_set_copy(intersection));
+  isl_union_set* complement = NULL;
+  isl_union_map* image = ciss_trace_enabled() ? isl_union_map_from_range(isl_union_set_copy(intersection)) : NULL;
+
+  // Images that miss or cover the whole domain, or were already used to split
+  // it, would only add redundant pieces.  Rejected images are not remembered,
+  // they are rejected again if they repeat.
+  if (isl_union_set_is_empty(intersection) ||
+      isl_union_set_is_subset(target_domain_uset, intersection) ||
+      ciss_statement_has_image(target, coalesced)) {
+    isl_union_set_free(target_domain_uset);
+    target->nb_skipped++;
+    outcome = "skipped";
+  } else {
+    complement = isl_union_set_subtract(target_domain_uset, isl_union_set_copy(intersection));
+    if (!ciss_cost_model_accepts(model, intersection, complement)) {
+      target->nb_rejected++;
+      outcome = "rejected";
+    } else {
+      target->nb_splits++;
+      outcome = "applied";
+      ciss_statement_add_image(target, coalesced);
+      if (cache->context != NULL) {
+        intersection = isl_union_set_gist_params(intersection, isl_set_copy(cache->context));
+        complement = isl_union_set_gist_params(complement, isl_set_copy(cache->context));
+      }
+
+      osl_relation_p first = isl_union_map_to_osl_relation(isl_union_map_from_range(intersection));
+      osl_relation_p second = isl_union_map_to_osl_relation(isl_union_map_from_range(complement));
+      LL_APPEND(osl_relation_t, first, second);
+      osl_relation_free(target->domain);
+      target->domain = first;
+      intersection = NULL;
+      complement = NULL;
+    }
+  }
+
+  ciss_trace_span_relation("split", start, image,
+                           "\"source\": %d, \"target\": %d, \"outcome\": \"%s\"",
+                           source->label, target->label, outcome);
+  isl_union_map_free(image);
+  isl_union_set_free(coalesced);
+  isl_union_set_free(intersection);
+  isl_union_set_free(complement);
+}
+
+// Comma-separated identifiers of the path arcs.
+static char* ciss_trace_path_arcs(ciss_graph_path* path) {
+  size_t length = 0, capacity = 64;
+  char* arcs = (char*) malloc(capacity);
+  arcs[0] = '\0';
+  for ( ; path != NULL; path = path->next) {
+    if (capacity - length < 24) {
+      capacity *= 2;
+      arcs = (char*) realloc(arcs, capacity);
+    }
+    length += (size_t) sprintf(arcs + length, length == 0 ? "%zu" : ", %zu", path->arc->id);
+  }
+  return arcs;
+}
+
+// we need to work on scattered domains to check for chunks in a transformed scop, but modify the original domain.
+void ciss_split_by_path(ciss_arc_cache* cache, ciss_cost_model* model,
+                        ciss_statement* source, ciss_statement* target, ciss_graph_path* path) {
+  double start = ciss_trace_now();
+  isl_union_map* dependence_umap = ciss_relation_compose_list_isl(path, cache->ctx, cache);
+  ciss_split_by_relation(cache, model, source, target, dependence_umap);
+  if (ciss_trace_enabled()) {
+    char* arcs = ciss_trace_path_arcs(path);
+    ciss_trace_span("path", start, "\"source\": %d, \"target\": %d, \"arcs\": [%s]",
+                    source->label, target->label, arcs);
+    free(arcs);
+  }
+}
+
+// Same as above, but for all paths described by the path expression at once.
+void ciss_split_by_kleene(ciss_arc_cache* cache, ciss_cost_model* model,
+                          ciss_statement* source, ciss_statement* target, ciss_kleene_element* element) {
+  double start = ciss_trace_now();
+  isl_union_map* dependence_umap = ciss_relation_compose_kleene_recurse(cache->ctx, cache, element);
+  if (dependence_umap != NULL)
+    ciss_split_by_relation(cache, model, source, target, dependence_umap);
+  ciss_trace_span("expression", start, "\"source\": %d, \"target\": %d", source->label, target->label);
+}
+
+//+/////////////// analysis handle
+ciss_handle* ciss_handle_create(ciss_options* options) {
+  ciss_handle* handle = (ciss_handle*) malloc(sizeof(ciss_handle));
+  handle->options = options;
+  handle->ctx = isl_ctx_alloc();
+  handle->analysis = NULL;
+  handle->pool = options->nb_threads > 1 ? ciss_pool_create(options->nb_threads) : NULL;
+  handle->cost = NULL;
+  if (options->min_chunk > 0)
+    handle->cost = ciss_cost_model_create(options->parameters, options->nb_parameters, options->min_chunk);
+  return handle;
+}
+
+static void ciss_analysis_destroy(ciss_analysis* analysis) {
+  if (analysis == NULL)
+    return;
+  ciss_box_filter_destroy(analysis->boxes);
+  ciss_arc_cache_destroy(analysis->cache);
+  ciss_statement_index_destroy(analysis->statements);
+  isl_set_free(analysis->context);
+  ciss_reachability_destroy(analysis->reach);
+  ciss_graph_destroy(analysis->graph);
+  osl_dependence_free(analysis->dependence);
+  candl_scop_usr_cleanup(analysis->scop);
+  osl_scop_free(analysis->scop);
+  free(analysis->settings);
+  free(analysis);
+}
+
+// Releases the state of the last analysis, keeps the isl context.
+void ciss_handle_clear(ciss_handle* handle) {
+  ciss_analysis_destroy(handle->analysis);
+  handle->analysis = NULL;
+}
+
+void ciss_handle_destroy(ciss_handle* handle) {
+  if (handle == NULL)
+    return;
+  ciss_handle_clear(handle);
+  ciss_pool_destroy(handle->pool);
+  ciss_cost_model_destroy(handle->cost);
+  isl_ctx_free(handle->ctx);
+  free(handle);
+}
+
+// Dependences of the scop computed by Candl, only of the selected kinds.
+static osl_dependence_p ciss_analysis_dependences(ciss_handle* handle, osl_scop_p scop) {
+  candl_options_p options = candl_options_malloc();
+  int types = handle->options->dependence_types;
+  osl_dependence_p dependence;
+  options->fullcheck = 1;
+  if (types != 0) {
+    // Do not let Candl compute dependences that are filtered out anyway.
+    options->raw = (types & CISS_DEPENDENCE_RAW) != 0;
+    options->war = (types & CISS_DEPENDENCE_WAR) != 0;
+    options->waw = (types & CISS_DEPENDENCE_WAW) != 0;
+    options->rar = (types & CISS_DEPENDENCE_RAR) != 0;
+  }
+  dependence = candl_dependence(scop, options);
+  candl_options_free(options);
+  return dependence;
+}
+
+// Builds the graph and the caches on top of the dependences of the scop, whose
+// statements Candl already labeled.  Takes ownership of the scop and of the
+// dependences, the analysis time counts from start.
+static ciss_analysis* ciss_analysis_build(ciss_handle* handle, osl_scop_p scop,
+                                          osl_dependence_p dependence, double start) {
+  ciss_analysis* analysis = (ciss_analysis*) malloc(sizeof(ciss_analysis));
+
+  analysis->scop = scop;
+  analysis->settings = ciss_options_settings(handle->options);
+  ciss_profile_init(&analysis->profile);
+  analysis->context = NULL;
+  if (scop->context != NULL)
+    analysis->context = isl_set_params(osl_relation_to_isl_set(handle->ctx, scop->context));
+  // Chunks whose size depends on parameters without values are unbounded,
+  // the cost model would accept every split.
+  if (handle->cost != NULL && scop->context != NULL &&
+      handle->options->nb_parameters < (size_t) scop->context->nb_parameters) {
+    fprintf(stderr, "-min-chunk accepts all parametric chunks, -params gives %zu of %d values\n",
+            handle->options->nb_parameters, scop->context->nb_parameters);
+  }
+  analysis->statements = ciss_statement_index_create(handle->ctx, scop, analysis->context);
+  analysis->dependence = dependence;
+  analysis->graph = ciss_graph_construct_types(analysis->dependence, handle->options->dependence_types,
+                                               handle->options->merge);
+  if (handle->options->stats) {
+    fprintf(stderr, "[ciss] dependence graph: %zu nodes, %zu arcs\n",
+            ciss_graph_node_number(analysis->graph), analysis->graph->nb_arcs);
+  }
+  analysis->reach = ciss_reachability_create(analysis->graph);
+  analysis->cache = ciss_arc_cache_create(handle->ctx, analysis->graph, analysis->context);
+  analysis->boxes = NULL;
+  if (!handle->options->kleene)
+    analysis->boxes = ciss_box_filter_create(analysis->graph, analysis->statements);
+
+  analysis->profile.analysis = ciss_profile_time() - start;
+  return analysis;
+}
+
+// Computes dependences of the scop and builds the analysis on top.  Takes
+// ownership of the scop, only the first scop of a list is analyzed.
+static ciss_analysis* ciss_analysis_create(ciss_handle* handle, osl_scop_p scop) {
+  double start = ciss_profile_time();
+  osl_scop_free(scop->next);
+  scop->next = NULL;
+  candl_scop_usr_init(scop);
+  return ciss_analysis_build(handle, scop, ciss_analysis_dependences(handle, scop), start);
+}
+
+// Splits the statements of the last analysis whose labels are among the target
+// options and, unless dirty is NULL, in the dirty set of graph nodes.  Returns
+// 0 if paths were lost, the domains are then only partially split.
+static int ciss_handle_split_statements(ciss_handle* handle, const uint64_t* dirty) {
+  ciss_options* ciss_opts = handle->options;
+  ciss_analysis* analysis = handle->analysis;
+  ciss_reachability* reach = analysis->reach;
+  uint64_t* targets = NULL;
+  double start = ciss_profile_time();
+  int complete = 1;
+  size_t i;
+
+  if (ciss_opts->targets != NULL) {
+    targets = ciss_reachability_set_create(reach);
+    for (i = 0; i < ciss_opts->nb_targets; i++) {
+      ciss_graph_node* node = ciss_graph_find_node(analysis->graph, ciss_opts->targets[i]);
+      if (node != NULL)
+        ciss_reachability_set_insert(targets, ciss_reachability_index(reach, node));
+    }
+  }
+  if (dirty != NULL) {
+    if (targets == NULL) {
+      targets = ciss_reachability_set_create(reach);
+      memcpy(targets, dirty, sizeof(uint64_t) * reach->nb_words);
+    } else {
+      for (i = 0; i < reach->nb_words; i++)
+        targets[i] &= dirty[i];
+    }
+  }
+
+  if (ciss_opts->kleene) {
+    // Only build path expressions for pairs that are connected by some path.
+    ciss_kleene_query* queries = ciss_kleene_reachable_queries(reach, targets);
+    ciss_kleene_query* query;
+    ciss_kleene_build_queries(reach, queries, ciss_opts->kleene_order);
+    if (ciss_opts->stats) {
+      ciss_kleene_stats stats;
+      ciss_kleene_query_stats(queries, &stats);
+      fprintf(stderr, "[ciss] path expressions: %zu elements, %zu compositions, %zu unions, %zu closures\n",
+              stats.nb_elements, stats.nb_compositions, stats.nb_unions, stats.nb_closures);
+    }
+    analysis->profile.paths += ciss_profile_time() - start;
+    start = ciss_profile_time();
+    if (handle->pool != NULL) {
+      // Relations are computed in parallel, domains are still split in query order.
+      isl_union_map** relations = ciss_relation_compose_kleene_parallel(handle->pool, analysis->cache, queries);
+      for (query = queries, i = 0; query != NULL; query = query->next, i++) {
+        if (relations[i] == NULL)
+          continue;
+        ciss_split_by_relation(analysis->cache, handle->cost,
+                               ciss_statement_index_find(analysis->statements, query->source->label),
+                               ciss_statement_index_find(analysis->statements, query->target->label),
+                               relations[i]);
+      }
+      free(relations);
+    } else {
+      for (query = queries; query != NULL; query = query->next) {
+        ciss_split_by_kleene(analysis->cache, handle->cost,
+                             ciss_statement_index_find(analysis->statements, query->source->label),
+                             ciss_statement_index_find(analysis->statements, query->target->label),
+                             query->element);
+      }
+    }
+    ciss_kleene_query_destroy(queries);
+  } else {
+    ciss_path_store* store = ciss_path_store_create(analysis->graph, ciss_opts->memory_limit);
+    ciss_graph_path* path;
+    ciss_graph_path_point* p;
+    ciss_graph_store_paths_to(reach, targets, store);
+    analysis->profile.paths += ciss_profile_time() - start;
+    start = ciss_profile_time();
+    while ((path = ciss_path_store_next(store)) != NULL) {
+      for (p = path; p->next != NULL; p = p->next)
+        ;
+      ciss_statement* source = ciss_statement_index_find(analysis->statements, path->arc->source->label);
+      ciss_statement* target = ciss_statement_index_find(analysis->statements, p->arc->target->label);
+      // Paths whose image certainly misses the target are not worth an isl call.
+      if (!ciss_box_filter_path(analysis->boxes, analysis->cache, source, target, path))
+        continue;
+      ciss_split_by_path(analysis->cache, handle->cost, source, target, path);
+    }
+    complete = !store->failed;
+    if (ciss_opts->stats) {
+      fprintf(stderr, "[ciss] path store: %zu paths, %zu bytes spilled to disk\n",
+              store->nb_paths, store->nb_spilled * sizeof(uint32_t));
+      fprintf(stderr, "[ciss] box filter: %zu paths passed, %zu skipped\n",
+              analysis->boxes->nb_passed, analysis->boxes->nb_filtered);
+    }
+    ciss_path_store_destroy(store);
+  }
+  analysis->profile.splitting += ciss_profile_time() - start;
+
+  if (ciss_opts->stats) {
+    size_t nb_splits = 0, nb_skipped = 0, nb_rejected = 0;
+    for (i = 0; i < analysis->statements->nb_statements; i++) {
+      nb_splits += analysis->statements->statements[i].nb_splits;
+      nb_skipped += analysis->statements->statements[i].nb_skipped;
+      nb_rejected += analysis->statements->statements[i].nb_rejected;
+    }
+    fprintf(stderr, "[ciss] splits: %zu applied, %zu skipped, %zu rejected as too small\n",
+            nb_splits, nb_skipped, nb_rejected);
+    ciss_profile_print(stderr, &analysis->profile);
+  }
+  free(targets);
+  return complete;
+}
+
+// Copies of the split domains of the last analysis, in the order of the scop
+// statements.
+static osl_relation_list_p ciss_handle_domains(ciss_handle* handle) {
+  osl_relation_list_p domains = NULL;
+  osl_relation_list_p last = NULL;
+  osl_statement_p stmt;
+
+  for (stmt = handle->analysis->scop->statement; stmt != NULL; stmt = stmt->next) {
+    candl_statement_usr_p stmt_usr = (candl_statement_usr_p) stmt->usr;
+    osl_relation_list_p node =
+        osl_relation_list_node(ciss_statement_index_find(handle->analysis->statements,
+                                                         stmt_usr->label)->domain);
+    if (last == NULL)
+      domains = node;
+    else
+      last->next = node;
+    last = node;
+  }
+  return domains;
+}
+
+// Returns the split domains of all statements, in the order of the scop
+// statements, or NULL if splitting failed.  The handle analyzes a copy of the
+// scop.
+osl_relation_list_p ciss_handle_split(ciss_handle* handle, osl_scop_p scop) {
+  ciss_handle_clear(handle);
+  handle->analysis = ciss_analysis_create(handle, osl_scop_clone(scop));
+  if (!ciss_handle_split_statements(handle, NULL))
+    return NULL;
+  return ciss_handle_domains(handle);
+}
+
+//+/////////////// incremental analysis
+// Dependences of different scops are compared field by field since their
+// statement and access pointers necessarily differ.
+static int ciss_dependence_equal(osl_dependence_p dep1, osl_dependence_p dep2) {
+  return dep1->label_source == dep2->label_source &&
+         dep1->label_target == dep2->label_target &&
+         dep1->ref_source == dep2->ref_source &&
+         dep1->ref_target == dep2->ref_target &&
+         dep1->depth == dep2->depth &&
+         dep1->type == dep2->type &&
+         osl_relation_equal(dep1->domain, dep2->domain);
+}
+
+static int ciss_arc_same_dependences(ciss_graph_arc* arc1, ciss_graph_arc* arc2) {
+  ciss_graph_dependence_list* merged1 = arc1->merged;
+  ciss_graph_dependence_list* merged2 = arc2->merged;
+  if (!ciss_dependence_equal(arc1->dependence, arc2->dependence))
+    return 0;
+  for (; merged1 != NULL && merged2 != NULL; merged1 = merged1->next, merged2 = merged2->next) {
+    if (!ciss_dependence_equal(merged1->dependence, merged2->dependence))
+      return 0;
+  }
+  return merged1 == NULL && merged2 == NULL;
+}
+
+// Finds an arc of the analysis between the same statements and carrying the
+// same dependences as the given arc of another analysis.
+static ciss_graph_arc* ciss_analysis_find_arc(ciss_analysis* analysis, ciss_graph_arc* arc) {
+  ciss_graph_node* node = ciss_graph_find_node(analysis->graph, arc->source->label);
+  ciss_graph_arc* candidate;
+  if (node == NULL)
+    return NULL;
+  for (candidate = node->outgoing; candidate != NULL; candidate = candidate->next) {
+    if (candidate->target->label == arc->target->label &&
+        ciss_arc_same_dependences(candidate, arc))
+      return candidate;
+  }
+  return NULL;
+}
+
+static void ciss_analysis_mark_reachable(ciss_analysis* analysis, int label, char* dirty) {
+  ciss_graph_node* node = ciss_graph_find_node(analysis->graph, label);
+  ciss_reachability* reach = analysis->reach;
+  uint64_t* row;
+  size_t i;
+  if (node == NULL)
+    return;
+  row = ciss_reachability_row(reach, ciss_reachability_index(reach, node));
+  for (i = 0; i < reach->nb_nodes; i++) {
+    if (ciss_reachability_set_contains(row, i))
+      dirty[reach->nodes[i]->label] = 1;
+  }
+}
+
+// Incremental update only applies to scops with as many statements and the
+// same context, analyzed under the same settings.
+static int ciss_analysis_compatible(ciss_analysis* previous, ciss_analysis* analysis) {
+  return strcmp(previous->settings, analysis->settings) == 0 &&
+         previous->statements->nb_statements == analysis->statements->nb_statements &&
+         osl_relation_equal(previous->scop->context, analysis->scop->context);
+}
+
+// Returns the labels whose split may differ from the previous analysis:
+// changed statements, targets of arcs that appeared or disappeared, and
+// everything reachable from them in either graph.  Relations of unchanged arcs
+// are moved to the new cache on the way.
+static char* ciss_analysis_diff(ciss_analysis* previous, ciss_analysis* analysis) {
+  size_t nb_labels = analysis->statements->nb_statements;
+  char* changed = (char*) calloc(nb_labels + 1, sizeof(char));
+  char* dirty = (char*) calloc(nb_labels + 1, sizeof(char));
+  ciss_graph_node* node;
+  ciss_graph_arc* arc;
+  ciss_graph_arc* match;
+  size_t i;
+
+  for (i = 0; i < nb_labels; i++) {
+    ciss_statement* old_record = ciss_statement_index_find(previous->statements, (int) i);
+    ciss_statement* record = ciss_statement_index_find(analysis->statements, (int) i);
+    if ((old_record == NULL) != (record == NULL) ||
+        (record != NULL && !osl_statement_equal(old_record->stmt_ptr, record->stmt_ptr)))
+      changed[i] = 1;
+  }
+
+  for (node = analysis->graph->nodes; node != NULL; node = node->next) {
+    for (arc = node->outgoing; arc != NULL; arc = arc->next) {
+      match = ciss_analysis_find_arc(previous, arc);
+      if (match == NULL)
+        changed[arc->target->label] = 1;
+      else
+        ciss_arc_cache_adopt(analysis->cache, arc, previous->cache, match);
+    }
+  }
+  for (node = previous->graph->nodes; node != NULL; node = node->next) {
+    for (arc = node->outgoing; arc != NULL; arc = arc->next) {
+      if (ciss_analysis_find_arc(analysis, arc) == NULL)
+        changed[arc->target->label] = 1;
+    }
+  }
+
+  for (i = 0; i < nb_labels; i++) {
+    if (!changed[i])
+      continue;
+    dirty[i] = 1;
+    ciss_analysis_mark_reachable(previous, (int) i, dirty);
+    ciss_analysis_mark_reachable(analysis, (int) i, dirty);
+  }
+  free(changed);
+  return dirty;
+}
+
+// Splits the scop reusing the last analysis of the handle: only statements
+// affected by changed statements or dependences are split again, the others
+// keep their previous split domains.  Falls back to a full split if there is
+// no comparable analysis.  Returns NULL if splitting failed.
+osl_relation_list_p ciss_handle_update(ciss_handle* handle, osl_scop_p scop) {
+  ciss_analysis* previous = handle->analysis;
+  ciss_analysis* analysis;
+  ciss_reachability* reach;
+  uint64_t* targets;
+  char* dirty;
+  size_t i, nb_dirty = 0;
+  int complete;
+
+  if (previous == NULL)
+    return ciss_handle_split(handle, scop);
+
+  analysis = ciss_analysis_create(handle, osl_scop_clone(scop));
+  handle->analysis = analysis;
+  if (!ciss_analysis_compatible(previous, analysis)) {
+    if (strcmp(previous->settings, analysis->settings) != 0)
+      fprintf(stderr, "[ciss] options differ from the previous analysis, splitting all statements\n");
+    ciss_analysis_destroy(previous);
+    if (!ciss_handle_split_statements(handle, NULL))
+      return NULL;
+    return ciss_handle_domains(handle);
+  }
+
+  dirty = ciss_analysis_diff(previous, analysis);
+  reach = analysis->reach;
+  targets = ciss_reachability_set_create(reach);
+  for (i = 0; i < analysis->statements->nb_statements; i++) {
+    ciss_statement* record = ciss_statement_index_find(analysis->statements, (int) i);
+    ciss_graph_node* node;
+    if (record == NULL)
+      continue;
+    if (dirty[i]) {
+      nb_dirty++;
+      node = ciss_graph_find_node(analysis->graph, (int) i);
+      if (node != NULL)
+        ciss_reachability_set_insert(targets, ciss_reachability_index(reach, node));
+    } else {
+      osl_relation_free(record->domain);
+      record->domain =
+          osl_relation_clone(ciss_statement_index_find(previous->statements, (int) i)->domain);
+    }
+  }
+  if (handle->options->stats) {
+    fprintf(stderr, "[ciss] incremental update: %zu of %zu statements split again\n",
+            nb_dirty, analysis->statements->nb_statements);
+  }
+  ciss_analysis_destroy(previous);
+
+  complete = ciss_handle_split_statements(handle, targets);
+  free(targets);
+  free(dirty);
+  if (!complete)
+    return NULL;
+  return ciss_handle_domains(handle);
+}
+
+// Writes the last analysis as a line with its settings followed by two scops:
+// the analyzed scop with its dependences as an extension, absent if there are
+// none, and the same scop with split domains.  Returns 0 if there is nothing to save.
+int ciss_handle_save(ciss_handle* handle, FILE* file) {
+  ciss_analysis* analysis = handle->analysis;
+  osl_scop_p analyzed;
+  osl_scop_p result;
+  osl_generic_p dependences;
+  osl_statement_p stmt;
+  osl_statement_p split;
+
+  if (analysis == NULL)
+    return 0;
+
+  analyzed = osl_scop_clone(analysis->scop);
+  osl_generic_remove(&analyzed->extension, OSL_URI_DEPENDENCE);
+  dependences = NULL;
+  if (analysis->dependence != NULL) {
+    dependences = osl_generic_shell(analysis->dependence, osl_dependence_interface());
+    osl_generic_add(&analyzed->extension, dependences);
+  }
+
+  result = osl_scop_clone(analysis->scop);
+  for (stmt = analysis->scop->statement, split = result->statement;
+       stmt != NULL && split != NULL;
+       stmt = stmt->next, split = split->next) {
+    candl_statement_usr_p stmt_usr = (candl_statement_usr_p) stmt->usr;
+    osl_relation_free(split->domain);
+    split->domain =
+        osl_relation_clone(ciss_statement_index_find(analysis->statements, stmt_usr->label)->domain);
+  }
+  fprintf(file, "# ciss settings: %s\n", analysis->settings);
+  osl_scop_print(file, analyzed);
+  osl_scop_print(file, result);
+
+  // Dependences remain owned by the analysis.
+  if (dependences != NULL)
+    dependences->data = NULL;
+  osl_scop_free(analyzed);
+  osl_scop_free(result);
+  return 1;
+}
+
+// Reads the settings line written by ciss_handle_save, NULL if there is none.
+static char* ciss_handle_read_settings(FILE* file) {
+  static const char prefix[] = "# ciss settings: ";
+  size_t length = 0, capacity = 128;
+  char* settings = (char*) malloc(capacity);
+  int c;
+
+  while ((c = fgetc(file)) != EOF && c != '\n') {
+    if (length + 1 == capacity) {
+      capacity *= 2;
+      settings = (char*) realloc(settings, capacity);
+    }
+    settings[length++] = (char) c;
+  }
+  settings[length] = '\0';
+  if (c == EOF || strncmp(settings, prefix, sizeof(prefix) - 1) != 0) {
+    free(settings);
+    return NULL;
+  }
+  memmove(settings, settings + sizeof(prefix) - 1, length - (sizeof(prefix) - 1) + 1);
+  return settings;
+}
+
+// Restores the state written by ciss_handle_save.  Dependences and split
+// domains are taken from the file, Candl does not run again.  Returns 0 if the
+// file does not hold a saved state.
+int ciss_handle_load(ciss_handle* handle, FILE* file) {
+  char* settings = ciss_handle_read_settings(file);
+  osl_scop_p scop = settings != NULL ? osl_scop_read(file) : NULL;
+  osl_scop_p result;
+  osl_dependence_p dependence;
+  osl_generic_p generic;
+  osl_statement_p stmt;
+  osl_statement_p split;
+
+  if (scop == NULL || scop->next == NULL) {
+    osl_scop_free(scop);
+    free(settings);
+    return 0;
+  }
+  result = scop->next;
+  scop->next = NULL;
+
+  // Take the dependences over from the extension.
+  dependence = osl_generic_lookup(scop->extension, OSL_URI_DEPENDENCE);
+  for (generic = scop->extension; generic != NULL; generic = generic->next) {
+    if (dependence != NULL && generic->data == dependence)
+      generic->data = NULL;
+  }
+  osl_generic_remove(&scop->extension, OSL_URI_DEPENDENCE);
+  candl_scop_usr_init(scop);
+  if (dependence != NULL)
+    candl_dependence_init_fields(scop, dependence);
+
+  ciss_handle_clear(handle);
+  handle->analysis = ciss_analysis_build(handle, scop, dependence, ciss_profile_time());
+  free(handle->analysis->settings);
+  handle->analysis->settings = settings;
+  for (stmt = scop->statement, split = result->statement;
+       stmt != NULL && split != NULL;
+       stmt = stmt->next, split = split->next) {
+    candl_statement_usr_p stmt_usr = (candl_statement_usr_p) stmt->usr;
+    ciss_statement* record = ciss_statement_index_find(handle->analysis->statements, stmt_usr->label);
+    osl_relation_free(record->domain);
+    record->domain = split->domain;
+    split->domain = NULL;
+  }
+  osl_scop_free(result);
+  return 1;
+}
@@ -0,0 +1,88 @@
+#ifndef CISS_H
+#define CISS_H
+
+#include <osl/osl.h>
+#include <osl/extensions/dependence.h>
+
+#include <stdio.h>
+
+#include <isl/ctx.h>
+#include <isl/set.h>
+#include <isl/union_map.h>
+
+#include "box.h"
+#include "cache.h"
+#include "cost.h"
+#include "graph.h"
+#include "options.h"
+#include "path.h"
+#include "pathstore.h"
+#include "pool.h"
+#include "profile.h"
+#include "reach.h"
+#include "statement.h"
+
+// State of one analysis.  Analysis has ownership of its copy of the scop and
+// of everything computed from it.
+typedef struct ciss_analysis {
+  osl_scop_p scop;
+  char* settings;  // Options the split depends on, see ciss_options_settings.
+  osl_dependence_p dependence;
+  ciss_graph* graph;
+  ciss_reachability* reach;
+  isl_set* context;
+  ciss_statement_index* statements;
+  ciss_arc_cache* cache;
+  ciss_box_filter* boxes;  // Path pre-filter, NULL in Kleene mode.
+  ciss_profile profile;
+} ciss_analysis;
+
+// Analysis handle, reusable across scops.  Handle has ownership of the isl
+// context, of the last analysis, of the pool and of the cost model, but not of
+// the options.
+typedef struct ciss_handle {
+  ciss_options* options;
+  isl_ctx* ctx;
+  ciss_analysis* analysis;  // Last analysis, NULL if none.
+  ciss_pool* pool;          // Workers evaluating path expressions, NULL if sequential.
+  ciss_cost_model* cost;    // Chunk size estimates, NULL if every split is accepted.
+} ciss_handle;
+
+//+/// analysis handle
+ciss_handle* ciss_handle_create(ciss_options*);
+void ciss_handle_destroy(ciss_handle*);
+void ciss_handle_clear(ciss_handle*);
+osl_relation_list_p ciss_handle_split(ciss_handle*, osl_scop_p);
+
+//+/// incremental analysis
+osl_relation_list_p ciss_handle_update(ciss_handle*, osl_scop_p);
+int ciss_handle_save(ciss_handle*, FILE*);
+int ciss_handle_load(ciss_handle*, FILE*);
+
+//+/// graph construction and path enumeration
+int ciss_dependence_type(osl_dependence_p);
+ciss_graph* ciss_graph_construct(osl_dependence_p);
+ciss_graph* ciss_graph_construct_types(osl_dependence_p, int, int);
+void ciss_dfs_pu(ciss_graph_node*, void (*)(ciss_graph_path*, void*), void*);
+void ciss_dfs_pu_targets(ciss_graph_node*, ciss_reachability*, const uint64_t*,
+                         void (*)(ciss_graph_path*, void*), void*);
+ciss_graph_path_list* ciss_graph_all_paths(ciss_graph*);
+void ciss_graph_store_paths_to(ciss_reachability*, const uint64_t*, ciss_path_store*);
+void ciss_graph_path_list_print(ciss_graph_path_list*);
+
+//+/// relation composition
+isl_union_map* ciss_relation_compose_list_isl(ciss_graph_path*, isl_ctx*, ciss_arc_cache*);
+osl_relation_p ciss_relation_compose_list(ciss_graph_path*);
+isl_union_map* ciss_relation_compose_kleene_recurse(isl_ctx*, ciss_arc_cache*, ciss_kleene_element*);
+osl_relation_p ciss_relation_compose_kleene(ciss_kleene_element*);
+isl_union_map** ciss_relation_compose_kleene_parallel(ciss_pool*, ciss_arc_cache*, ciss_kleene_query*);
+
+//+/// domain splitting
+void ciss_split_by_relation(ciss_arc_cache*, ciss_cost_model*, ciss_statement*, ciss_statement*,
+                            isl_union_map*);
+void ciss_split_by_path(ciss_arc_cache*, ciss_cost_model*, ciss_statement*, ciss_statement*,
+                        ciss_graph_path*);
+void ciss_split_by_kleene(ciss_arc_cache*, ciss_cost_model*, ciss_statement*, ciss_statement*,
+                          ciss_kleene_element*);
+
+#endif // CISS_H
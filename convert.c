@@ -1,5 +1,7 @@
 #include "convert.h"
 
+#include <stdio.h>
+
 __isl_give isl_basic_map* osl_relation_part_to_isl_basic_map(isl_ctx* ctx, osl_relation_p relation) {
   isl_space* space;
   isl_mat* eq_mat;
@@ -9,6 +11,13 @@ __isl_give isl_basic_map* osl_relation_part_to_isl_basic_map(isl_ctx* ctx, osl_r
   int eq_row = 0, ineq_row = 0;
 
   space = isl_space_alloc(ctx, relation->nb_parameters, relation->nb_input_dims, relation->nb_output_dims);
+  // Parameters are named by position, as isl would when printing them, so that
+  // relations read back from strings align with the converted ones.
+  for (i = 0; i < relation->nb_parameters; i++) {
+    char name[16];
+    snprintf(name, sizeof(name), "p%d", i);
+    space = isl_space_set_dim_name(space, isl_dim_param, i, name);
+  }
 
   for (i = 0; i < relation->nb_rows; i++) {
     if (osl_int_zero(osl_util_get_precision(), relation->m[i][0])) {
@@ -74,6 +83,28 @@ __isl_give isl_union_map* osl_relation_to_isl_union_map(isl_ctx* ctx, osl_relati
   return umap;
 }
 
+__isl_give isl_set* osl_relation_to_isl_set(isl_ctx* ctx, osl_relation_p relation) {
+  return isl_set_from_union_set(isl_union_map_range(osl_relation_to_isl_union_map(ctx, relation)));
+}
+
+// Dependence relation between statement iterations, access dimensions are projected out.
+__isl_give isl_union_map* osl_dependence_to_isl_union_map(isl_ctx* ctx, osl_dependence_p dependence) {
+  isl_union_map* dependence_umap = osl_relation_to_isl_union_map(ctx, dependence->domain);
+  // XXX: assuming dependence domain is not a union of anything (true with Candl not supporting unions)
+  // otherwise, we would need to access target_nb_output_dims_domain for each part of the union
+  // since it may be different.
+  isl_map* dependence_map = isl_map_from_union_map(dependence_umap);
+  dependence_map = isl_map_project_out(dependence_map,
+                                       isl_dim_in,
+                                       dependence->target_nb_output_dims_domain,
+                                       dependence->target_nb_output_dims_access);
+  dependence_map = isl_map_project_out(dependence_map,
+                                       isl_dim_out,
+                                       dependence->source_nb_output_dims_domain,
+                                       dependence->source_nb_output_dims_access);
+  return isl_union_map_from_map(dependence_map);
+}
+
 osl_relation_p isl_basic_map_to_osl_relation(__isl_take isl_basic_map* bmap) {
   int i, j, eq_mat_rows;
   isl_mat* eq_mat = isl_basic_map_equalities_matrix(bmap, isl_dim_out, isl_dim_in, isl_dim_div, isl_dim_param, isl_dim_cst);
@@ -95,7 +126,7 @@ osl_relation_p isl_basic_map_to_osl_relation(__isl_take isl_basic_map* bmap) {
     }
   }
   for (i = 0; i < isl_mat_rows(ineq_mat); i++) {
-    osl_int_set_si(osl_util_get_precision(), &relation->m[i][0], 1);
+    osl_int_set_si(osl_util_get_precision(), &relation->m[eq_mat_rows + i][0], 1);
     for (j = 0; j < isl_mat_cols(ineq_mat); j++) {
       isl_val* val = isl_mat_get_element_val(ineq_mat, i, j);
       int value = isl_val_get_num_si(val) / isl_val_get_den_si(val);
@@ -3,6 +3,7 @@
 
 #include <osl/osl.h>
 #include <osl/relation.h>
+#include <osl/extensions/dependence.h>
 
 #include <isl/ctx.h>
 #include <isl/space.h>
@@ -13,6 +14,8 @@
 #include <isl/union_map.h>
 
 __isl_give isl_union_map* osl_relation_to_isl_union_map(isl_ctx* ctx, osl_relation_p relation);
+__isl_give isl_set* osl_relation_to_isl_set(isl_ctx* ctx, osl_relation_p relation);
+__isl_give isl_union_map* osl_dependence_to_isl_union_map(isl_ctx* ctx, osl_dependence_p dependence);
 osl_relation_p isl_basic_map_to_osl_relation(__isl_take isl_basic_map* bmap);
 osl_relation_p isl_union_map_to_osl_relation(__isl_take isl_union_map* umap);
 
@@ -0,0 +1,85 @@
+#include "cost.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <isl/val.h>
+
+ciss_cost_model* ciss_cost_model_create(const long* parameters, size_t nb_parameters, double min_chunk) {
+  ciss_cost_model* model = (ciss_cost_model*) malloc(sizeof(ciss_cost_model));
+  model->nb_parameters = nb_parameters;
+  model->parameters = (long*) malloc(sizeof(long) * (nb_parameters + 1));
+  if (nb_parameters != 0)
+    memcpy(model->parameters, parameters, sizeof(long) * nb_parameters);
+  model->min_chunk = min_chunk;
+  return model;
+}
+
+void ciss_cost_model_destroy(ciss_cost_model* model) {
+  if (model == NULL)
+    return;
+  free(model->parameters);
+  free(model);
+}
+
+typedef struct ciss_cost_model_sum {
+  ciss_cost_model* model;
+  double volume;
+} ciss_cost_model_sum;
+
+// Extent of a bounding box dimension, infinite if unbounded.
+static double ciss_cost_model_extent(__isl_keep isl_set* set, int pos) {
+  isl_val* min = isl_set_dim_min_val(isl_set_copy(set), pos);
+  isl_val* max = isl_set_dim_max_val(isl_set_copy(set), pos);
+  double extent = HUGE_VAL;
+  if (min != NULL && max != NULL && !isl_val_is_infty(max) && !isl_val_is_neginfty(min) &&
+      !isl_val_is_nan(min) && !isl_val_is_nan(max))
+    extent = floor(isl_val_get_d(max)) - ceil(isl_val_get_d(min)) + 1;
+  isl_val_free(min);
+  isl_val_free(max);
+  return extent;
+}
+
+static int ciss_cost_model_volume_helper(__isl_take isl_set* set, void* usr) {
+  ciss_cost_model_sum* sum = (ciss_cost_model_sum*) usr;
+  int nb_params = isl_set_dim(set, isl_dim_param);
+  int nb_dims = isl_set_dim(set, isl_dim_set);
+  double volume = 1;
+  int i;
+
+  for (i = 0; i < nb_params && (size_t) i < sum->model->nb_parameters; i++) {
+    isl_val* value = isl_val_int_from_si(isl_set_get_ctx(set), sum->model->parameters[i]);
+    set = isl_set_fix_val(set, isl_dim_param, i, value);
+  }
+  if (isl_set_is_empty(set)) {
+    isl_set_free(set);
+    return 0;
+  }
+  for (i = 0; i < nb_dims && volume < HUGE_VAL; i++) {
+    volume *= ciss_cost_model_extent(set, i);
+  }
+  sum->volume += volume;
+  isl_set_free(set);
+  return 0;
+}
+
+// Sum of the bounding box volumes of the sets of the union.
+double ciss_cost_model_volume(ciss_cost_model* model, isl_union_set* uset) {
+  ciss_cost_model_sum sum;
+  sum.model = model;
+  sum.volume = 0;
+  isl_union_set_foreach_set(uset, &ciss_cost_model_volume_helper, &sum);
+  return sum.volume;
+}
+
+// A split is accepted if both resulting chunks are at least as large as the
+// threshold.  Empty chunks do not count, they are not generated.
+int ciss_cost_model_accepts(ciss_cost_model* model, isl_union_set* first, isl_union_set* second) {
+  double first_volume, second_volume;
+  if (model == NULL || model->min_chunk <= 0)
+    return 1;
+  first_volume = ciss_cost_model_volume(model, first);
+  second_volume = ciss_cost_model_volume(model, second);
+  return (first_volume == 0 || first_volume >= model->min_chunk) &&
+         (second_volume == 0 || second_volume >= model->min_chunk);
+}
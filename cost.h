@@ -0,0 +1,24 @@
+#ifndef COST_H
+#define COST_H
+
+#include <stdlib.h>
+
+#include <isl/set.h>
+#include <isl/union_set.h>
+
+// Estimates the number of points of a chunk by the volume of its bounding box
+// under fixed parameter values.  Parameters without a value, and chunks
+// unbounded after fixing them, are considered infinitely large.
+typedef struct ciss_cost_model {
+  size_t nb_parameters;
+  long* parameters;  // Values of the first scop parameters, in order.
+  double min_chunk;  // Splits leaving a smaller chunk are rejected.
+} ciss_cost_model;
+
+ciss_cost_model* ciss_cost_model_create(const long*, size_t, double);
+void ciss_cost_model_destroy(ciss_cost_model*);
+
+double ciss_cost_model_volume(ciss_cost_model*, __isl_keep isl_union_set*);
+int ciss_cost_model_accepts(ciss_cost_model*, __isl_keep isl_union_set*, __isl_keep isl_union_set*);
+
+#endif // COST_H
@@ -16,6 +16,7 @@ ciss_graph_node* ciss_graph_node_create(int label) {
   node->label = label;
   node->outgoing = NULL;
   node->incoming = NULL;
+  node->domain_ptr = NULL;
   node->next = NULL;
   return node;
 }
@@ -29,23 +30,76 @@ void ciss_graph_node_append_arc(ciss_graph_node* node,
   LL_APPEND(ciss_graph_arc, node->outgoing, arc);
 }
 
-void ciss_graph_connect_nodes(ciss_graph_node* source,
-                              ciss_graph_node* target,
-                              osl_dependence_p dep) {
+static void ciss_graph_connect_nodes_id(ciss_graph_node* source,
+                                        ciss_graph_node* target,
+                                        osl_dependence_p dep,
+                                        size_t id) {
   ciss_graph_arc* outgoing_arc = ciss_graph_arc_create(source, target, dep);
   ciss_graph_arc* incoming_arc = ciss_graph_arc_create(source, target, dep);
+  outgoing_arc->id = id;
+  incoming_arc->id = id;
   LL_APPEND(ciss_graph_arc, source->outgoing, outgoing_arc);
   LL_APPEND(ciss_graph_arc, target->incoming, incoming_arc);
 }
 
+void ciss_graph_connect_nodes(ciss_graph_node* source,
+                              ciss_graph_node* target,
+                              osl_dependence_p dep) {
+  ciss_graph_connect_nodes_id(source, target, dep, 0);
+}
+
+// Same as above, but numbers the arc within the graph.
+void ciss_graph_connect(ciss_graph* graph,
+                        ciss_graph_node* source,
+                        ciss_graph_node* target,
+                        osl_dependence_p dep) {
+  ciss_graph_connect_nodes_id(source, target, dep, graph->nb_arcs++);
+}
+
+static void ciss_graph_arc_merge(ciss_graph_arc* arc, osl_dependence_p dep) {
+  ciss_graph_dependence_list* element =
+      (ciss_graph_dependence_list*) malloc(sizeof(ciss_graph_dependence_list));
+  element->dependence = dep;
+  element->next = NULL;
+  LL_APPEND(ciss_graph_dependence_list, arc->merged, element);
+}
+
+// Same as above, but adds the dependence to the existing arc between the
+// nodes if any, so that nodes are connected by at most one arc.
+void ciss_graph_connect_merge(ciss_graph* graph,
+                              ciss_graph_node* source,
+                              ciss_graph_node* target,
+                              osl_dependence_p dep) {
+  ciss_graph_arc* outgoing_arc;
+  ciss_graph_arc* incoming_arc;
+
+  for (outgoing_arc = source->outgoing; outgoing_arc != NULL; outgoing_arc = outgoing_arc->next) {
+    if (outgoing_arc->target == target)
+      break;
+  }
+  if (outgoing_arc == NULL) {
+    ciss_graph_connect(graph, source, target, dep);
+    return;
+  }
+
+  for (incoming_arc = target->incoming; incoming_arc != NULL; incoming_arc = incoming_arc->next) {
+    if (incoming_arc->id == outgoing_arc->id)
+      break;
+  }
+  ciss_graph_arc_merge(outgoing_arc, dep);
+  ciss_graph_arc_merge(incoming_arc, dep);
+}
+
 //+/////////////// arc-related
 ciss_graph_arc* ciss_graph_arc_create(ciss_graph_node* source,
                                       ciss_graph_node* target,
                                       osl_dependence_p dep) {
   ciss_graph_arc* arc = (ciss_graph_arc*) malloc(sizeof(ciss_graph_arc));
+  arc->id = 0;
   arc->source = source;
   arc->target = target;
   arc->dependence = dep;
+  arc->merged = NULL;
   arc->next = NULL;
   return arc;
 }
@@ -55,6 +109,7 @@ ciss_graph_arc* ciss_graph_arc_malloc() {
 }
 
 void ciss_graph_arc_free(ciss_graph_arc* arc) {
+  LL_FREE(ciss_graph_dependence_list, arc->merged);
   free(arc);
 }
 
@@ -80,6 +135,7 @@ int ciss_graph_arc_equal(ciss_graph_arc* a1, ciss_graph_arc* a2) {
 ciss_graph* ciss_graph_create() {
   ciss_graph* graph = (ciss_graph*) malloc(sizeof(ciss_graph));
   graph->nodes = NULL;
+  graph->nb_arcs = 0;
   return graph;
 }
 
@@ -87,6 +143,28 @@ ciss_graph* ciss_graph_malloc() {
   return ciss_graph_create();
 }
 
+static void ciss_graph_arc_list_free(ciss_graph_arc* arc) {
+  ciss_graph_arc* next;
+  for ( ; arc != NULL; arc = next) {
+    next = arc->next;
+    ciss_graph_arc_free(arc);
+  }
+}
+
+void ciss_graph_destroy(ciss_graph* graph) {
+  ciss_graph_node* node;
+  if (graph == NULL)
+    return;
+  while (graph->nodes != NULL) {
+    node = graph->nodes->next;
+    ciss_graph_arc_list_free(graph->nodes->outgoing);
+    ciss_graph_arc_list_free(graph->nodes->incoming);
+    free(graph->nodes);
+    graph->nodes = node;
+  }
+  free(graph);
+}
+
 ciss_graph_node* ciss_graph_find_node(ciss_graph* graph, int label) {
   ciss_graph_node* node;
   for (node = graph->nodes; node != NULL; node = node->next) {
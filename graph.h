@@ -8,7 +8,7 @@ struct osl_dependence;
 struct osl_relation;
 
 // Graph node has ownership of its children.
-// Graph node has ownership of dependence stored.
+// Graph does not have ownership of dependences stored in the arcs.
 typedef struct ciss_graph_node {
   int label;
   struct ciss_graph_arc* outgoing;
@@ -17,15 +17,26 @@ typedef struct ciss_graph_node {
   struct ciss_graph_node* next;
 } ciss_graph_node;
 
+// Further dependences between the same nodes when parallel arcs are merged.
+typedef struct ciss_graph_dependence_list {
+  struct osl_dependence* dependence;
+  struct ciss_graph_dependence_list* next;
+} ciss_graph_dependence_list;
+
+// Outgoing and incoming copies of the same arc share the identifier.
+// Arc has ownership of the merged dependence list, but not of the dependences.
 typedef struct ciss_graph_arc {
+  size_t id;
   struct ciss_graph_node* source;
   struct ciss_graph_node* target;
   struct osl_dependence* dependence;
+  struct ciss_graph_dependence_list* merged;
   struct ciss_graph_arc* next;
 } ciss_graph_arc;
 
 typedef struct ciss_graph {
   struct ciss_graph_node* nodes;
+  size_t nb_arcs;
 } ciss_graph;
 
 //+/// node-related functions
@@ -44,6 +55,7 @@ int ciss_graph_arc_equal(ciss_graph_arc*, ciss_graph_arc*);
 //+/// graph-related functions
 ciss_graph* ciss_graph_create();
 ciss_graph* ciss_graph_malloc();
+void ciss_graph_destroy(ciss_graph*);
 
 ciss_graph_node* ciss_graph_find_node(ciss_graph*, int);
 void ciss_graph_append_node(ciss_graph*, ciss_graph_node*);
@@ -53,5 +65,13 @@ ciss_graph_node* ciss_graph_ensure_node(ciss_graph*, int);
 void ciss_graph_connect_nodes(ciss_graph_node* source,
                               ciss_graph_node* target,
                               struct osl_dependence* dep);
+void ciss_graph_connect(ciss_graph* graph,
+                        ciss_graph_node* source,
+                        ciss_graph_node* target,
+                        struct osl_dependence* dep);
+void ciss_graph_connect_merge(ciss_graph* graph,
+                              ciss_graph_node* source,
+                              ciss_graph_node* target,
+                              struct osl_dependence* dep);
 
 #endif // GRAPH_H
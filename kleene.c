@@ -0,0 +1,633 @@
+#include "kleene.h"
+#include "linked_list.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+//+/////////////// pointer set, used to walk shared path expressions once
+typedef struct ciss_pointer_set {
+  size_t capacity;
+  size_t size;
+  void** slots;
+} ciss_pointer_set;
+
+static void ciss_pointer_set_init(ciss_pointer_set* set) {
+  set->capacity = 0;
+  set->size = 0;
+  set->slots = NULL;
+}
+
+static void ciss_pointer_set_clear(ciss_pointer_set* set) {
+  free(set->slots);
+  ciss_pointer_set_init(set);
+}
+
+static size_t ciss_pointer_set_slot(ciss_pointer_set* set, void* ptr) {
+  uintptr_t hash = (uintptr_t) ptr;
+  size_t slot;
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  for (slot = hash & (set->capacity - 1);
+       set->slots[slot] != NULL && set->slots[slot] != ptr;
+       slot = (slot + 1) & (set->capacity - 1))
+    ;
+  return slot;
+}
+
+static int ciss_pointer_set_contains(ciss_pointer_set* set, void* ptr) {
+  if (set->capacity == 0)
+    return 0;
+  return set->slots[ciss_pointer_set_slot(set, ptr)] != NULL;
+}
+
+// Returns 1 if the pointer was not in the set before.
+static int ciss_pointer_set_insert(ciss_pointer_set* set, void* ptr) {
+  size_t i, slot;
+  if (2 * (set->size + 1) > set->capacity) {
+    ciss_pointer_set grown;
+    grown.capacity = set->capacity == 0 ? 64 : 2 * set->capacity;
+    grown.size = set->size;
+    grown.slots = (void**) calloc(grown.capacity, sizeof(void*));
+    for (i = 0; i < set->capacity; i++) {
+      if (set->slots[i] != NULL)
+        grown.slots[ciss_pointer_set_slot(&grown, set->slots[i])] = set->slots[i];
+    }
+    free(set->slots);
+    *set = grown;
+  }
+
+  slot = ciss_pointer_set_slot(set, ptr);
+  if (set->slots[slot] != NULL)
+    return 0;
+  set->slots[slot] = ptr;
+  set->size++;
+  return 1;
+}
+
+//+/////////////// path expression DAG traversal
+static void ciss_kleene_collect(ciss_pointer_set* set, ciss_kleene_element* element) {
+  ciss_kleene_element_list* iter;
+  if (element == NULL || !ciss_pointer_set_insert(set, element))
+    return;
+
+  switch (element->type) {
+  case LIST_SEQUENCE:
+  case LIST_ALTERNATIVES:
+    for (iter = element->list; iter != NULL; iter = iter->next) {
+      ciss_kleene_collect(set, iter->element);
+    }
+    break;
+  case STAR:
+    ciss_kleene_collect(set, element->star);
+    break;
+  default:
+    break;
+  }
+}
+
+// Appends composite elements after their operands.
+static void ciss_kleene_collect_postorder(ciss_pointer_set* set, ciss_kleene_element* element,
+                                          ciss_kleene_element*** elements, size_t* nb_elements,
+                                          size_t* capacity) {
+  ciss_kleene_element_list* iter;
+  if (element == NULL || !ciss_pointer_set_insert(set, element))
+    return;
+
+  switch (element->type) {
+  case LIST_SEQUENCE:
+  case LIST_ALTERNATIVES:
+    for (iter = element->list; iter != NULL; iter = iter->next) {
+      ciss_kleene_collect_postorder(set, iter->element, elements, nb_elements, capacity);
+    }
+    break;
+  case STAR:
+    ciss_kleene_collect_postorder(set, element->star, elements, nb_elements, capacity);
+    break;
+  default:
+    return;
+  }
+
+  if (*nb_elements == *capacity) {
+    *capacity = *capacity == 0 ? 16 : 2 * *capacity;
+    *elements = (ciss_kleene_element**) realloc(*elements, sizeof(ciss_kleene_element*) * *capacity);
+  }
+  (*elements)[(*nb_elements)++] = element;
+}
+
+static void ciss_kleene_element_free(ciss_kleene_element* element) {
+  if (element->type == LIST_SEQUENCE || element->type == LIST_ALTERNATIVES) {
+    LL_FREE(ciss_kleene_element_list, element->list);
+  }
+  free(element);
+}
+
+// Frees all elements of the collected set that are not in the live set.
+static void ciss_kleene_free_dead(ciss_pointer_set* collected, ciss_pointer_set* live) {
+  size_t i;
+  for (i = 0; i < collected->capacity; i++) {
+    void* element = collected->slots[i];
+    if (element != NULL && (live == NULL || !ciss_pointer_set_contains(live, element)))
+      ciss_kleene_element_free((ciss_kleene_element*) element);
+  }
+}
+
+//+/////////////// queries
+ciss_kleene_query* ciss_kleene_query_create(ciss_graph_node* source, ciss_graph_node* target) {
+  ciss_kleene_query* query = (ciss_kleene_query*) malloc(sizeof(ciss_kleene_query));
+  query->source = source;
+  query->target = target;
+  query->element = NULL;
+  query->next = NULL;
+  return query;
+}
+
+void ciss_kleene_query_destroy(ciss_kleene_query* queries) {
+  ciss_pointer_set elements;
+  ciss_kleene_query* query;
+
+  ciss_pointer_set_init(&elements);
+  for (query = queries; query != NULL; query = query->next) {
+    ciss_kleene_collect(&elements, query->element);
+  }
+  ciss_kleene_free_dead(&elements, NULL);
+  ciss_pointer_set_clear(&elements);
+  LL_FREE(ciss_kleene_query, queries);
+}
+
+// Composite elements (sequences, alternatives and closures) of all path
+// expressions, each once and after its operands.  The caller frees the array.
+ciss_kleene_element** ciss_kleene_query_elements(ciss_kleene_query* queries, size_t* nb_elements) {
+  ciss_pointer_set visited;
+  ciss_kleene_element** elements = NULL;
+  ciss_kleene_query* query;
+  size_t capacity = 0;
+
+  *nb_elements = 0;
+  ciss_pointer_set_init(&visited);
+  for (query = queries; query != NULL; query = query->next) {
+    ciss_kleene_collect_postorder(&visited, query->element, &elements, nb_elements, &capacity);
+  }
+  ciss_pointer_set_clear(&visited);
+  return elements;
+}
+
+// Creates a query for every (source, target) pair connected by a non-empty path,
+// restricted to the given targets unless NULL.
+ciss_kleene_query* ciss_kleene_reachable_queries(ciss_reachability* reach, const uint64_t* targets) {
+  ciss_kleene_query* queries = NULL;
+  ciss_kleene_query* last = NULL;
+  size_t s, t;
+
+  for (s = 0; s < reach->nb_nodes; s++) {
+    uint64_t* row = ciss_reachability_row(reach, s);
+    for (t = 0; t < reach->nb_nodes; t++) {
+      if (!ciss_reachability_set_contains(row, t))
+        continue;
+      if (targets != NULL && !ciss_reachability_set_contains(targets, t))
+        continue;
+      ciss_kleene_query* query = ciss_kleene_query_create(reach->nodes[s], reach->nodes[t]);
+      if (last == NULL)
+        queries = query;
+      else
+        last->next = query;
+      last = query;
+    }
+  }
+  return queries;
+}
+
+//+/////////////// elimination orders
+// Tarjan's algorithm, strongly connected components are numbered in reverse
+// topological order.
+typedef struct ciss_kleene_tarjan {
+  ciss_reachability* reach;
+  size_t* number;
+  size_t* lowlink;
+  size_t* component;
+  size_t* stack;
+  char* on_stack;
+  size_t stack_size;
+  size_t counter;
+  size_t nb_components;
+} ciss_kleene_tarjan;
+
+static void ciss_kleene_tarjan_visit(ciss_kleene_tarjan* tarjan, size_t v) {
+  ciss_graph_arc* arc;
+  size_t w;
+
+  tarjan->number[v] = tarjan->lowlink[v] = ++tarjan->counter;
+  tarjan->stack[tarjan->stack_size++] = v;
+  tarjan->on_stack[v] = 1;
+
+  for (arc = tarjan->reach->nodes[v]->outgoing; arc != NULL; arc = arc->next) {
+    w = tarjan->reach->by_label[arc->target->label];
+    if (tarjan->number[w] == 0) {
+      ciss_kleene_tarjan_visit(tarjan, w);
+      if (tarjan->lowlink[w] < tarjan->lowlink[v])
+        tarjan->lowlink[v] = tarjan->lowlink[w];
+    } else if (tarjan->on_stack[w] && tarjan->number[w] < tarjan->lowlink[v]) {
+      tarjan->lowlink[v] = tarjan->number[w];
+    }
+  }
+
+  if (tarjan->lowlink[v] == tarjan->number[v]) {
+    do {
+      w = tarjan->stack[--tarjan->stack_size];
+      tarjan->on_stack[w] = 0;
+      tarjan->component[w] = tarjan->nb_components;
+    } while (w != v);
+    tarjan->nb_components++;
+  }
+}
+
+// Nodes ordered by strongly connected components in topological order, nodes
+// of the same component keep the linked-list order.
+static size_t* ciss_kleene_scc_order(ciss_reachability* reach) {
+  ciss_kleene_tarjan tarjan;
+  size_t n = reach->nb_nodes;
+  size_t* order = (size_t*) malloc(sizeof(size_t) * (n + 1));
+  size_t i, c, position = 0;
+
+  tarjan.reach = reach;
+  tarjan.number = (size_t*) calloc(n + 1, sizeof(size_t));
+  tarjan.lowlink = (size_t*) calloc(n + 1, sizeof(size_t));
+  tarjan.component = (size_t*) calloc(n + 1, sizeof(size_t));
+  tarjan.stack = (size_t*) malloc(sizeof(size_t) * (n + 1));
+  tarjan.on_stack = (char*) calloc(n + 1, 1);
+  tarjan.stack_size = 0;
+  tarjan.counter = 0;
+  tarjan.nb_components = 0;
+
+  for (i = 0; i < n; i++) {
+    if (tarjan.number[i] == 0)
+      ciss_kleene_tarjan_visit(&tarjan, i);
+  }
+  for (c = tarjan.nb_components; c > 0; c--) {
+    for (i = 0; i < n; i++) {
+      if (tarjan.component[i] == c - 1)
+        order[position++] = i;
+    }
+  }
+
+  free(tarjan.number);
+  free(tarjan.lowlink);
+  free(tarjan.component);
+  free(tarjan.stack);
+  free(tarjan.on_stack);
+  return order;
+}
+
+//+/////////////// single-source state elimination
+// The matrix holds expressions for the original nodes, followed by a virtual
+// source that has the same outgoing arcs as the actual source (thus only
+// non-empty paths are described) and by one virtual sink per target that is
+// reachable from the target by (epsilon).  Eliminating all original nodes
+// leaves the path expressions between the virtual source and sinks.
+typedef struct ciss_kleene_matrix {
+  size_t n;
+  size_t m;
+  ciss_kleene_element** r;
+  size_t* in_degree;  // Non-empty entries in the column, except the diagonal.
+  size_t* out_degree; // Non-empty entries in the row, except the diagonal.
+  size_t* fill;       // Fill of eliminating each remaining node, NULL unless
+                      // ordering by fill.
+  char* eliminated;
+} ciss_kleene_matrix;
+
+static void ciss_kleene_matrix_set(ciss_kleene_matrix* matrix,
+                                   size_t p,
+                                   size_t q,
+                                   ciss_kleene_element* element) {
+  size_t m = matrix->m;
+  ciss_kleene_element** entry = &matrix->r[p * m + q];
+  size_t k;
+  if ((*entry == NULL) == (element == NULL)) {
+    *entry = element;
+    return;
+  }
+  if (p != q) {
+    if (element != NULL) {
+      matrix->out_degree[p]++;
+      matrix->in_degree[q]++;
+    } else {
+      matrix->out_degree[p]--;
+      matrix->in_degree[q]--;
+    }
+  }
+  // Eliminating any k between p and q fills this entry only while it is empty.
+  if (matrix->fill != NULL) {
+    for (k = 0; k < matrix->n; k++) {
+      if (k == p || k == q || matrix->eliminated[k] ||
+          matrix->r[p * m + k] == NULL || matrix->r[k * m + q] == NULL)
+        continue;
+      if (element != NULL)
+        matrix->fill[k]--;
+      else
+        matrix->fill[k]++;
+    }
+  }
+  *entry = element;
+}
+
+// Number of entries that become non-empty when eliminating k.
+static size_t ciss_kleene_matrix_fill(ciss_kleene_matrix* matrix, size_t k) {
+  size_t m = matrix->m;
+  size_t p, q, fill = 0;
+  for (p = 0; p < m; p++) {
+    if (p == k || matrix->r[p * m + k] == NULL)
+      continue;
+    for (q = 0; q < m; q++) {
+      if (q != k && matrix->r[k * m + q] != NULL && matrix->r[p * m + q] == NULL)
+        fill++;
+    }
+  }
+  return fill;
+}
+
+// Static orders are already reflected in the order of the matrix rows.
+static size_t ciss_kleene_matrix_select(ciss_kleene_matrix* matrix,
+                                        ciss_kleene_order order,
+                                        size_t step) {
+  size_t k, best = matrix->n;
+  size_t cost, best_cost = 0;
+
+  if (order == CISS_KLEENE_ORDER_LIST || order == CISS_KLEENE_ORDER_SCC)
+    return step;
+
+  for (k = 0; k < matrix->n; k++) {
+    if (matrix->eliminated[k])
+      continue;
+    if (order == CISS_KLEENE_ORDER_MIN_DEGREE)
+      cost = matrix->in_degree[k] + matrix->out_degree[k];
+    else
+      cost = matrix->fill[k];
+    if (best == matrix->n || cost < best_cost) {
+      best = k;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
+static void ciss_kleene_eliminate_source(ciss_reachability* reach,
+                                         ciss_kleene_element** base,
+                                         size_t source,
+                                         ciss_kleene_query** targets,
+                                         size_t nb_targets,
+                                         ciss_kleene_order order,
+                                         const size_t* static_order,
+                                         ciss_pointer_set* consumed) {
+  ciss_kleene_matrix matrix;
+  size_t nb_nodes = reach->nb_nodes;
+  size_t* local = (size_t*) malloc(sizeof(size_t) * (nb_nodes + 1));
+  size_t* global_to_local = (size_t*) malloc(sizeof(size_t) * (nb_nodes + 1));
+  uint64_t* target_set = ciss_reachability_set_create(reach);
+  uint64_t* from_source = ciss_reachability_row(reach, source);
+  size_t n, m, sigma, step, g, k, p, q, t;
+  size_t* neighbours;
+  size_t nb_neighbours;
+
+  // Only nodes lying on some path from the source to a target are kept.
+  for (t = 0; t < nb_targets; t++) {
+    ciss_reachability_set_insert(target_set, ciss_reachability_index(reach, targets[t]->target));
+  }
+  n = 0;
+  for (step = 0; step < nb_nodes; step++) {
+    g = static_order != NULL ? static_order[step] : step;
+    global_to_local[g] = nb_nodes;
+    if (ciss_reachability_set_contains(from_source, g) &&
+        (ciss_reachability_set_contains(target_set, g) ||
+         ciss_reachability_row_intersects(reach, g, target_set))) {
+      global_to_local[g] = n;
+      local[n++] = g;
+    }
+  }
+  free(target_set);
+
+  m = n + 1 + nb_targets;
+  sigma = n;
+  matrix.n = n;
+  matrix.m = m;
+  matrix.r = (ciss_kleene_element**) calloc(m * m, sizeof(ciss_kleene_element*));
+  matrix.in_degree = (size_t*) calloc(m, sizeof(size_t));
+  matrix.out_degree = (size_t*) calloc(m, sizeof(size_t));
+  matrix.fill = NULL;
+  matrix.eliminated = (char*) calloc(m, 1);
+  neighbours = (size_t*) malloc(sizeof(size_t) * (n + 1));
+
+  for (p = 0; p < n; p++) {
+    for (q = 0; q < n; q++) {
+      ciss_kleene_matrix_set(&matrix, p, q, base[local[p] * nb_nodes + local[q]]);
+    }
+  }
+  for (q = 0; q < n; q++) {
+    ciss_kleene_matrix_set(&matrix, sigma, q, base[source * nb_nodes + local[q]]);
+  }
+  for (t = 0; t < nb_targets; t++) {
+    size_t target = global_to_local[ciss_reachability_index(reach, targets[t]->target)];
+    if (target == nb_nodes)
+      continue;
+    ciss_kleene_matrix_set(&matrix, target, n + 1 + t,
+                           ciss_kleene_element_create_epsilon(targets[t]->target));
+  }
+
+  if (order == CISS_KLEENE_ORDER_MIN_FILL) {
+    matrix.fill = (size_t*) malloc(sizeof(size_t) * (n + 1));
+    for (k = 0; k < n; k++) {
+      matrix.fill[k] = ciss_kleene_matrix_fill(&matrix, k);
+    }
+  }
+
+  for (step = 0; step < n; step++) {
+    k = ciss_kleene_matrix_select(&matrix, order, step);
+    ciss_kleene_element* loop = matrix.r[k * m + k];
+    ciss_kleene_element* star = NULL;
+
+    // Entries set while eliminating k keep the fill of the other nodes up to
+    // date, except for the neighbours of k whose rows and columns change.
+    nb_neighbours = 0;
+    for (p = 0; matrix.fill != NULL && p < n; p++) {
+      if (p != k && !matrix.eliminated[p] && (matrix.r[p * m + k] != NULL || matrix.r[k * m + p] != NULL))
+        neighbours[nb_neighbours++] = p;
+    }
+
+    for (p = 0; p < m; p++) {
+      ciss_kleene_element* prefix = NULL;
+      if (p == k || matrix.r[p * m + k] == NULL)
+        continue;
+
+      for (q = 0; q < m; q++) {
+        if (q == k || matrix.r[k * m + q] == NULL)
+          continue;
+        if (prefix == NULL) {
+          if (loop != NULL && star == NULL)
+            star = ciss_kleene_element_closure(loop, reach->nodes[local[k]]);
+          prefix = star == NULL ? matrix.r[p * m + k]
+                                : ciss_kleene_element_sequence(matrix.r[p * m + k], star);
+        }
+        // The previous entry may have been inlined into the new one.
+        ciss_kleene_collect(consumed, matrix.r[p * m + q]);
+        ciss_kleene_matrix_set(&matrix, p, q,
+            ciss_kleene_element_alternative(matrix.r[p * m + q],
+                                            ciss_kleene_element_sequence(prefix, matrix.r[k * m + q])));
+      }
+      // So may the prefix, and then nothing else refers to it.
+      ciss_kleene_collect(consumed, prefix);
+    }
+    ciss_kleene_collect(consumed, star);
+
+    for (p = 0; p < m; p++) {
+      ciss_kleene_collect(consumed, matrix.r[p * m + k]);
+      ciss_kleene_collect(consumed, matrix.r[k * m + p]);
+      ciss_kleene_matrix_set(&matrix, p, k, NULL);
+      ciss_kleene_matrix_set(&matrix, k, p, NULL);
+    }
+    matrix.eliminated[k] = 1;
+    for (p = 0; p < nb_neighbours; p++) {
+      matrix.fill[neighbours[p]] = ciss_kleene_matrix_fill(&matrix, neighbours[p]);
+    }
+  }
+
+  for (t = 0; t < nb_targets; t++) {
+    targets[t]->element = matrix.r[sigma * m + n + 1 + t];
+  }
+  free(matrix.r);
+  free(matrix.in_degree);
+  free(matrix.out_degree);
+  free(matrix.fill);
+  free(matrix.eliminated);
+  free(neighbours);
+  free(local);
+  free(global_to_local);
+}
+
+void ciss_kleene_build_queries(ciss_reachability* reach,
+                               ciss_kleene_query* queries,
+                               ciss_kleene_order order) {
+  ciss_kleene_element** base;
+  ciss_kleene_query** targets;
+  ciss_kleene_query* query;
+  ciss_kleene_query* other;
+  ciss_pointer_set consumed, live;
+  ciss_graph_arc* arc;
+  size_t* static_order = NULL;
+  char* done;
+  size_t n = reach->nb_nodes;
+  size_t i, nb_targets, max_targets = 0;
+
+  if (order == CISS_KLEENE_ORDER_SCC)
+    static_order = ciss_kleene_scc_order(reach);
+
+  // Direct arcs between nodes, shared by all sources.  Alternatives of three
+  // or more parallel arcs replace the previous ones, which are freed with the
+  // other intermediate expressions.
+  ciss_pointer_set_init(&consumed);
+  base = (ciss_kleene_element**) calloc(n * n + 1, sizeof(ciss_kleene_element*));
+  for (i = 0; i < n; i++) {
+    for (arc = reach->nodes[i]->outgoing; arc != NULL; arc = arc->next) {
+      ciss_kleene_element** element = &base[i * n + ciss_reachability_index(reach, arc->target)];
+      ciss_kleene_collect(&consumed, *element);
+      *element = ciss_kleene_element_alternative(*element, ciss_kleene_element_create_single(arc));
+    }
+  }
+
+  for (query = queries; query != NULL; query = query->next) {
+    max_targets++;
+  }
+  targets = (ciss_kleene_query**) malloc(sizeof(ciss_kleene_query*) * (max_targets + 1));
+  done = (char*) calloc(n + 1, 1);
+
+  for (query = queries; query != NULL; query = query->next) {
+    size_t source = ciss_reachability_index(reach, query->source);
+    if (done[source])
+      continue;
+    done[source] = 1;
+
+    // Pairs without a path between them are left empty.
+    nb_targets = 0;
+    for (other = query; other != NULL; other = other->next) {
+      if (other->source == query->source &&
+          ciss_reachability_reaches(reach, other->source, other->target))
+        targets[nb_targets++] = other;
+    }
+    if (nb_targets != 0)
+      ciss_kleene_eliminate_source(reach, base, source, targets, nb_targets,
+                                   order, static_order, &consumed);
+  }
+
+  // Free intermediate expressions that did not make it into any query.
+  for (i = 0; i < n * n; i++) {
+    ciss_kleene_collect(&consumed, base[i]);
+  }
+  ciss_pointer_set_init(&live);
+  for (query = queries; query != NULL; query = query->next) {
+    ciss_kleene_collect(&live, query->element);
+  }
+  ciss_kleene_free_dead(&consumed, &live);
+  ciss_pointer_set_clear(&consumed);
+  ciss_pointer_set_clear(&live);
+
+  free(static_order);
+  free(done);
+  free(targets);
+  free(base);
+}
+
+//+/////////////// statistics
+// Operations are counted once per distinct element, i.e. assuming shared
+// subexpressions are evaluated once.
+void ciss_kleene_query_stats(ciss_kleene_query* queries, ciss_kleene_stats* stats) {
+  ciss_pointer_set elements;
+  ciss_kleene_query* query;
+  ciss_kleene_element_list* iter;
+  size_t i, nb_operands;
+
+  stats->nb_elements = 0;
+  stats->nb_compositions = 0;
+  stats->nb_unions = 0;
+  stats->nb_closures = 0;
+
+  ciss_pointer_set_init(&elements);
+  for (query = queries; query != NULL; query = query->next) {
+    ciss_kleene_collect(&elements, query->element);
+  }
+
+  for (i = 0; i < elements.capacity; i++) {
+    ciss_kleene_element* element = (ciss_kleene_element*) elements.slots[i];
+    if (element == NULL)
+      continue;
+    stats->nb_elements++;
+
+    switch (element->type) {
+    case LIST_SEQUENCE:
+      nb_operands = 0;
+      for (iter = element->list; iter != NULL; iter = iter->next) {
+        if (iter->element->type == EPSILON)
+          continue;
+        // A closure inside a sequence is composed and united with the prefix.
+        if (nb_operands != 0 && iter->element->type == STAR)
+          stats->nb_unions++;
+        nb_operands++;
+      }
+      if (nb_operands > 1)
+        stats->nb_compositions += nb_operands - 1;
+      break;
+    case LIST_ALTERNATIVES:
+      nb_operands = 0;
+      for (iter = element->list; iter != NULL; iter = iter->next) {
+        nb_operands++;
+      }
+      if (nb_operands > 1)
+        stats->nb_unions += nb_operands - 1;
+      break;
+    case STAR:
+      stats->nb_closures++;
+      break;
+    default:
+      break;
+    }
+  }
+  ciss_pointer_set_clear(&elements);
+}
@@ -0,0 +1,44 @@
+#ifndef KLEENE_H
+#define KLEENE_H
+
+#include <stdint.h>
+
+#include "graph.h"
+#include "path.h"
+#include "reach.h"
+
+// Query has ownership of the path expression, but not of the nodes.
+// Path expressions of queries built together may share subexpressions,
+// destroy the whole query list at once.
+typedef struct ciss_kleene_query {
+  struct ciss_graph_node* source;
+  struct ciss_graph_node* target;
+  struct ciss_kleene_element* element;
+  struct ciss_kleene_query* next;
+} ciss_kleene_query;
+
+typedef enum ciss_kleene_order {
+  CISS_KLEENE_ORDER_LIST,       // Linked-list order of the graph nodes.
+  CISS_KLEENE_ORDER_MIN_DEGREE, // Node with the fewest predecessors and successors first.
+  CISS_KLEENE_ORDER_MIN_FILL,   // Node creating the fewest new entries first.
+  CISS_KLEENE_ORDER_SCC         // Strongly connected components in topological order.
+} ciss_kleene_order;
+
+typedef struct ciss_kleene_stats {
+  size_t nb_elements;
+  size_t nb_compositions;
+  size_t nb_unions;
+  size_t nb_closures;
+} ciss_kleene_stats;
+
+//+/// query-related functions
+ciss_kleene_query* ciss_kleene_query_create(ciss_graph_node*, ciss_graph_node*);
+void ciss_kleene_query_destroy(ciss_kleene_query*);
+ciss_kleene_query* ciss_kleene_reachable_queries(ciss_reachability*, const uint64_t*);
+ciss_kleene_element** ciss_kleene_query_elements(ciss_kleene_query*, size_t*);
+
+//+/// path expression construction
+void ciss_kleene_build_queries(ciss_reachability*, ciss_kleene_query*, ciss_kleene_order);
+void ciss_kleene_query_stats(ciss_kleene_query*, ciss_kleene_stats*);
+
+#endif // KLEENE_H
@@ -0,0 +1,270 @@
+#include "options.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ciss_options* ciss_options_create() {
+  ciss_options* options = (ciss_options*) malloc(sizeof(ciss_options));
+  options->kleene = 0;
+  options->kleene_order = CISS_KLEENE_ORDER_LIST;
+  options->stats = 0;
+  options->all = 0;
+  options->dependence_types = 0;
+  options->merge = 0;
+  options->targets = NULL;
+  options->nb_targets = 0;
+  options->parameters = NULL;
+  options->nb_parameters = 0;
+  options->min_chunk = 0;
+  options->nb_threads = 1;
+  options->memory_limit = 0;
+  options->trace = NULL;
+  options->state = NULL;
+  return options;
+}
+
+ciss_options* ciss_options_malloc() {
+  return ciss_options_create();
+}
+
+void ciss_options_free(ciss_options* options) {
+  if (options == NULL)
+    return;
+  free(options->targets);
+  free(options->parameters);
+  free(options);
+}
+
+void ciss_options_print_usage(const char* program) {
+  fprintf(stderr, "Usage: %s [options] < input.scop\n", program);
+  fprintf(stderr, "  -kleene   split by path expressions instead of enumerating paths\n");
+  fprintf(stderr, "  -order <list|degree|fill|scc>\n");
+  fprintf(stderr, "            node elimination order for path expressions (default: list)\n");
+  fprintf(stderr, "  -params <value,...>\n");
+  fprintf(stderr, "            parameter values, in scop order, for chunk size estimates\n");
+  fprintf(stderr, "  -min-chunk <n>\n");
+  fprintf(stderr, "            reject splits leaving chunks of fewer than n points, needs -params\n");
+  fprintf(stderr, "            if the scop has parameters\n");
+  fprintf(stderr, "  -threads <n>\n");
+  fprintf(stderr, "            evaluate path expressions on n threads (default: 1)\n");
+  fprintf(stderr, "  -memory-limit <bytes>[k|M|G]\n");
+  fprintf(stderr, "            spill enumerated paths to disk beyond this size (default: none)\n");
+  fprintf(stderr, "  -stats    report statistics on stderr\n");
+  fprintf(stderr, "  -all      print the split domains of all statements\n");
+  fprintf(stderr, "  -deps <raw,war,waw,rar>\n");
+  fprintf(stderr, "            dependence kinds to consider (default: Candl defaults)\n");
+  fprintf(stderr, "  -merge    merge parallel arcs into one arc per pair of statements\n");
+  fprintf(stderr, "  -targets <label,...>\n");
+  fprintf(stderr, "            only split the domains of the given statements\n");
+  fprintf(stderr, "  -trace <file>\n");
+  fprintf(stderr, "            write a trace of the isl work in Chrome trace-event format\n");
+  fprintf(stderr, "  -state <file>\n");
+  fprintf(stderr, "            reuse the analysis saved in the file for unchanged statements\n");
+  fprintf(stderr, "            and save the new one there\n");
+}
+
+// Appends formatted text to a string of the given length and capacity.
+static char* ciss_options_append(char* str, size_t* length, size_t* capacity, const char* format, ...) {
+  va_list args;
+  int written;
+
+  va_start(args, format);
+  written = vsnprintf(str + *length, *capacity - *length, format, args);
+  va_end(args);
+  if ((size_t) written >= *capacity - *length) {
+    *capacity = 2 * *capacity + (size_t) written;
+    str = (char*) realloc(str, *capacity);
+    va_start(args, format);
+    vsnprintf(str + *length, *capacity - *length, format, args);
+    va_end(args);
+  }
+  *length += (size_t) written;
+  return str;
+}
+
+// Options that affect the split domains, on one line.  Analyses made under
+// different settings do not share their results.
+char* ciss_options_settings(ciss_options* options) {
+  size_t length = 0, capacity = 128;
+  char* settings = (char*) malloc(capacity);
+  size_t i;
+
+  settings[0] = '\0';
+  settings = ciss_options_append(settings, &length, &capacity,
+                                 "kleene %d order %d merge %d deps %d min-chunk %.17g params",
+                                 options->kleene, (int) options->kleene_order, options->merge,
+                                 options->dependence_types, options->min_chunk);
+  for (i = 0; i < options->nb_parameters; i++)
+    settings = ciss_options_append(settings, &length, &capacity, i == 0 ? " %ld" : ",%ld",
+                                   options->parameters[i]);
+  settings = ciss_options_append(settings, &length, &capacity, " targets");
+  for (i = 0; i < options->nb_targets; i++)
+    settings = ciss_options_append(settings, &length, &capacity, i == 0 ? " %d" : ",%d",
+                                   options->targets[i]);
+  return settings;
+}
+
+// Parses a comma-separated list of statement labels, returns 0 on error.
+static int ciss_options_read_targets(ciss_options* options, const char* str) {
+  char* end;
+  long label;
+
+  while (*str != '\0') {
+    label = strtol(str, &end, 10);
+    if (end == str || label < 0 || (*end != ',' && *end != '\0'))
+      return 0;
+    options->targets = (int*) realloc(options->targets, sizeof(int) * (options->nb_targets + 1));
+    options->targets[options->nb_targets++] = (int) label;
+    str = *end == ',' ? end + 1 : end;
+  }
+  return options->nb_targets != 0;
+}
+
+// Parses a comma-separated list of parameter values, returns 0 on error.
+static int ciss_options_read_parameters(ciss_options* options, const char* str) {
+  char* end;
+  long value;
+
+  while (*str != '\0') {
+    value = strtol(str, &end, 10);
+    if (end == str || (*end != ',' && *end != '\0'))
+      return 0;
+    options->parameters = (long*) realloc(options->parameters, sizeof(long) * (options->nb_parameters + 1));
+    options->parameters[options->nb_parameters++] = value;
+    str = *end == ',' ? end + 1 : end;
+  }
+  return options->nb_parameters != 0;
+}
+
+// Parses a positive size in bytes with an optional k, M or G suffix, returns 0
+// on error.
+static int ciss_options_read_size(size_t* size, const char* str) {
+  char* end;
+  long value = strtol(str, &end, 10);
+  size_t unit = 1;
+
+  if (end == str || value < 1)
+    return 0;
+  if (*end == 'k')
+    unit = (size_t) 1 << 10;
+  else if (*end == 'M')
+    unit = (size_t) 1 << 20;
+  else if (*end == 'G')
+    unit = (size_t) 1 << 30;
+  if (unit != 1)
+    end++;
+  if (*end != '\0' || (size_t) value > SIZE_MAX / unit)
+    return 0;
+  *size = (size_t) value * unit;
+  return 1;
+}
+
+// Parses a comma-separated list of dependence kinds, returns 0 on error.
+static int ciss_options_read_dependences(ciss_options* options, const char* str) {
+  static const char* names[] = {"raw", "war", "waw", "rar"};
+  static const int types[] = {CISS_DEPENDENCE_RAW, CISS_DEPENDENCE_WAR,
+                              CISS_DEPENDENCE_WAW, CISS_DEPENDENCE_RAR};
+  size_t i, length;
+
+  options->dependence_types = 0;
+  while (*str != '\0') {
+    length = strcspn(str, ",");
+    for (i = 0; i < 4; i++) {
+      if (strlen(names[i]) == length && strncmp(str, names[i], length) == 0)
+        break;
+    }
+    if (i == 4)
+      return 0;
+    options->dependence_types |= types[i];
+    str += length;
+    if (*str == ',')
+      str++;
+  }
+  return options->dependence_types != 0;
+}
+
+// Returns NULL if the command line could not be parsed.
+ciss_options* ciss_options_read(int argc, char** argv) {
+  ciss_options* options = ciss_options_create();
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-kleene") == 0) {
+      options->kleene = 1;
+    } else if (strcmp(argv[i], "-merge") == 0) {
+      options->merge = 1;
+    } else if (strcmp(argv[i], "-stats") == 0) {
+      options->stats = 1;
+    } else if (strcmp(argv[i], "-all") == 0) {
+      options->all = 1;
+    } else if (strcmp(argv[i], "-deps") == 0 && i + 1 < argc) {
+      if (!ciss_options_read_dependences(options, argv[++i])) {
+        fprintf(stderr, "Invalid dependence kinds: %s\n", argv[i]);
+        ciss_options_free(options);
+        return NULL;
+      }
+    } else if (strcmp(argv[i], "-targets") == 0 && i + 1 < argc) {
+      if (!ciss_options_read_targets(options, argv[++i])) {
+        fprintf(stderr, "Invalid statement labels: %s\n", argv[i]);
+        ciss_options_free(options);
+        return NULL;
+      }
+    } else if (strcmp(argv[i], "-params") == 0 && i + 1 < argc) {
+      if (!ciss_options_read_parameters(options, argv[++i])) {
+        fprintf(stderr, "Invalid parameter values: %s\n", argv[i]);
+        ciss_options_free(options);
+        return NULL;
+      }
+    } else if (strcmp(argv[i], "-min-chunk") == 0 && i + 1 < argc) {
+      char* end;
+      options->min_chunk = strtod(argv[++i], &end);
+      if (end == argv[i] || *end != '\0' || options->min_chunk < 0) {
+        fprintf(stderr, "Invalid chunk size: %s\n", argv[i]);
+        ciss_options_free(options);
+        return NULL;
+      }
+    } else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+      char* end;
+      long nb_threads = strtol(argv[++i], &end, 10);
+      if (end == argv[i] || *end != '\0' || nb_threads < 1) {
+        fprintf(stderr, "Invalid number of threads: %s\n", argv[i]);
+        ciss_options_free(options);
+        return NULL;
+      }
+      options->nb_threads = (size_t) nb_threads;
+    } else if (strcmp(argv[i], "-memory-limit") == 0 && i + 1 < argc) {
+      if (!ciss_options_read_size(&options->memory_limit, argv[++i])) {
+        fprintf(stderr, "Invalid memory limit: %s\n", argv[i]);
+        ciss_options_free(options);
+        return NULL;
+      }
+    } else if (strcmp(argv[i], "-trace") == 0 && i + 1 < argc) {
+      options->trace = argv[++i];
+    } else if (strcmp(argv[i], "-state") == 0 && i + 1 < argc) {
+      options->state = argv[++i];
+    } else if (strcmp(argv[i], "-order") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "list") == 0) {
+        options->kleene_order = CISS_KLEENE_ORDER_LIST;
+      } else if (strcmp(argv[i], "degree") == 0) {
+        options->kleene_order = CISS_KLEENE_ORDER_MIN_DEGREE;
+      } else if (strcmp(argv[i], "fill") == 0) {
+        options->kleene_order = CISS_KLEENE_ORDER_MIN_FILL;
+      } else if (strcmp(argv[i], "scc") == 0) {
+        options->kleene_order = CISS_KLEENE_ORDER_SCC;
+      } else {
+        fprintf(stderr, "Unknown elimination order: %s\n", argv[i]);
+        ciss_options_free(options);
+        return NULL;
+      }
+    } else {
+      fprintf(stderr, "Unknown option: %s\n", argv[i]);
+      ciss_options_free(options);
+      return NULL;
+    }
+  }
+  return options;
+}
@@ -0,0 +1,44 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdlib.h>
+
+#include "kleene.h"
+
+// Dependence kinds that become graph arcs.
+#define CISS_DEPENDENCE_RAW 0x1
+#define CISS_DEPENDENCE_WAR 0x2
+#define CISS_DEPENDENCE_WAW 0x4
+#define CISS_DEPENDENCE_RAR 0x8
+
+typedef struct ciss_options {
+  int kleene;  // Split by path expressions per (source, target) pair instead of
+               // enumerating every path.
+  ciss_kleene_order kleene_order;  // Node elimination order for path expressions.
+  int stats;   // Report statistics on stderr.
+  int all;     // Print the split domains of all statements, not only the first.
+  int dependence_types;  // CISS_DEPENDENCE_* mask, Candl defaults if 0.
+  int merge;   // One arc with the union of dependences per pair of statements.
+  int* targets;       // Labels of the statements to split, all if NULL.
+  size_t nb_targets;
+  long* parameters;   // Parameter values for chunk size estimates, in scop order.
+  size_t nb_parameters;
+  double min_chunk;   // Smallest estimated chunk a split may leave, any if 0.
+  size_t nb_threads;  // Workers evaluating path expressions, sequential if 1.
+  size_t memory_limit;  // Bytes of enumerated paths kept in memory before
+                        // spilling them to disk, no limit if 0.
+  const char* trace;  // Chrome trace-event file, none if NULL.  Points to the
+                      // command line argument.
+  const char* state;  // File keeping the analysis state between runs, none if
+                      // NULL.  Points to the command line argument.
+} ciss_options;
+
+ciss_options* ciss_options_create();
+ciss_options* ciss_options_malloc();
+void ciss_options_free(ciss_options*);
+
+ciss_options* ciss_options_read(int argc, char** argv);
+char* ciss_options_settings(ciss_options*);
+void ciss_options_print_usage(const char* program);
+
+#endif // OPTIONS_H
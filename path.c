@@ -52,6 +52,65 @@ ciss_kleene_element_list* ciss_kleene_element_list_append(ciss_kleene_element_li
   return list;
 }
 
+static int ciss_kleene_element_is_empty(ciss_kleene_element* element) {
+  return element == NULL || element->type == EMPTY;
+}
+
+// Appends the element to the list, inlining its own list if it is of the given type.
+static ciss_kleene_element_list* ciss_kleene_element_list_inline(ciss_kleene_element_list* list,
+                                                                 ciss_kleene_element* element,
+                                                                 int type) {
+  ciss_kleene_element_list* iter;
+  if ((int) element->type != type)
+    return ciss_kleene_element_list_append(list, element);
+
+  for (iter = element->list; iter != NULL; iter = iter->next) {
+    list = ciss_kleene_element_list_append(list, iter->element);
+  }
+  return list;
+}
+
+// (empty).x = x.(empty) = (empty), (epsilon).x = x.(epsilon) = x.
+ciss_kleene_element* ciss_kleene_element_sequence(ciss_kleene_element* first,
+                                                  ciss_kleene_element* second) {
+  ciss_kleene_element_list* list;
+  if (ciss_kleene_element_is_empty(first) || ciss_kleene_element_is_empty(second))
+    return NULL;
+  if (first->type == EPSILON)
+    return second;
+  if (second->type == EPSILON)
+    return first;
+
+  list = ciss_kleene_element_list_inline(NULL, first, LIST_SEQUENCE);
+  list = ciss_kleene_element_list_inline(list, second, LIST_SEQUENCE);
+  return ciss_kleene_element_create_list(list, LIST_SEQUENCE);
+}
+
+// (empty)|x = x|(empty) = x, x|x = x.
+ciss_kleene_element* ciss_kleene_element_alternative(ciss_kleene_element* first,
+                                                     ciss_kleene_element* second) {
+  ciss_kleene_element_list* list;
+  if (ciss_kleene_element_is_empty(first))
+    return ciss_kleene_element_is_empty(second) ? NULL : second;
+  if (ciss_kleene_element_is_empty(second) || first == second)
+    return first;
+
+  list = ciss_kleene_element_list_inline(NULL, first, LIST_ALTERNATIVES);
+  list = ciss_kleene_element_list_inline(list, second, LIST_ALTERNATIVES);
+  return ciss_kleene_element_create_list(list, LIST_ALTERNATIVES);
+}
+
+// (empty)* = (epsilon)* = (epsilon), (x*)* = x*.
+// The node is used to create (epsilon) if needed.
+ciss_kleene_element* ciss_kleene_element_closure(ciss_kleene_element* star,
+                                                 ciss_graph_node* node) {
+  if (ciss_kleene_element_is_empty(star) || star->type == EPSILON)
+    return ciss_kleene_element_create_epsilon(node);
+  if (star->type == STAR)
+    return star;
+  return ciss_kleene_element_create_star(star);
+}
+
 //int ciss_graph_path_contains_node(ciss_graph_path_point* start, ciss_graph_node* node) {
 //  ciss_graph_path_point* point;
 //  if (start == NULL || node == NULL)
@@ -137,10 +196,12 @@ void ciss_graph_path_list_destroy(ciss_graph_path_list* list) {
   if (list == NULL)
     return;
 
-  for (element = list; element != NULL; element = list->next) {
-    ciss_graph_path_destroy(element->path);
+  while (list != NULL) {
+    element = list->next;
+    ciss_graph_path_destroy(list->path);
+    free(list);
+    list = element;
   }
-  free(list);
 }
 
 // Clears the path list without destroying the paths
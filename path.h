@@ -52,6 +52,11 @@ ciss_kleene_element* ciss_kleene_element_create_star(ciss_kleene_element* star);
 ciss_kleene_element* ciss_kleene_element_create_epsilon(ciss_graph_node* node);
 ciss_kleene_element* ciss_kleene_element_create_empty();
 
+// Simplifying constructors, the empty language is represented by NULL.
+ciss_kleene_element* ciss_kleene_element_sequence(ciss_kleene_element* first, ciss_kleene_element* second);
+ciss_kleene_element* ciss_kleene_element_alternative(ciss_kleene_element* first, ciss_kleene_element* second);
+ciss_kleene_element* ciss_kleene_element_closure(ciss_kleene_element* star, ciss_graph_node* node);
+
 ciss_kleene_element_list* ciss_kleene_element_list_create(ciss_kleene_element* cke);
 ciss_kleene_element_list* ciss_kleene_element_list_append(ciss_kleene_element_list* list,
                                                           ciss_kleene_element* cke);
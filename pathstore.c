@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pathstore.h"
+
+#include <sys/mman.h>
+
+ciss_path_store* ciss_path_store_create(ciss_graph* graph, size_t memory_limit) {
+  ciss_path_store* store = (ciss_path_store*) malloc(sizeof(ciss_path_store));
+  ciss_graph_node* node;
+  ciss_graph_arc* arc;
+
+  store->nb_arcs = graph->nb_arcs;
+  store->arcs = (ciss_graph_arc**) calloc(store->nb_arcs + 1, sizeof(ciss_graph_arc*));
+  for (node = graph->nodes; node != NULL; node = node->next) {
+    for (arc = node->outgoing; arc != NULL; arc = arc->next) {
+      store->arcs[arc->id] = arc;
+    }
+  }
+  store->memory_limit = memory_limit;
+  store->buffer = NULL;
+  store->nb_buffered = 0;
+  store->buffer_capacity = 0;
+  store->spill = NULL;
+  store->nb_spilled = 0;
+  store->nb_paths = 0;
+  store->failed = 0;
+  store->reading = 0;
+  store->records = NULL;
+  store->nb_records = 0;
+  store->position = 0;
+  store->mapping = NULL;
+  store->mapping_size = 0;
+  store->points = NULL;
+  store->nb_points = 0;
+  return store;
+}
+
+void ciss_path_store_destroy(ciss_path_store* store) {
+  if (store == NULL)
+    return;
+  if (store->mapping != NULL)
+    munmap(store->mapping, store->mapping_size);
+  if (store->spill != NULL)
+    fclose(store->spill);
+  free(store->points);
+  free(store->buffer);
+  free(store->arcs);
+  free(store);
+}
+
+// Moves the buffered records to the spill file.  A short write leaves the
+// file out of step with the records, so any error fails the store.
+static int ciss_path_store_spill(ciss_path_store* store) {
+  if (store->spill == NULL)
+    store->spill = tmpfile();
+  if (store->spill == NULL ||
+      fwrite(store->buffer, sizeof(uint32_t), store->nb_buffered, store->spill) != store->nb_buffered) {
+    fprintf(stderr, "[ciss] could not write the path spill file\n");
+    store->failed = 1;
+    return 0;
+  }
+  store->nb_spilled += store->nb_buffered;
+  store->nb_buffered = 0;
+  return 1;
+}
+
+void ciss_path_store_append(ciss_path_store* store, ciss_graph_path* path) {
+  ciss_graph_path* point;
+  size_t length = 0;
+
+  if (store->failed)
+    return;
+  for (point = path; point != NULL; point = point->next)
+    length++;
+  if (length == 0)
+    return;
+  if (store->nb_buffered + length + 1 > store->buffer_capacity) {
+    store->buffer_capacity = 2 * store->buffer_capacity + length + 1;
+    store->buffer = (uint32_t*) realloc(store->buffer, sizeof(uint32_t) * store->buffer_capacity);
+  }
+
+  store->buffer[store->nb_buffered++] = (uint32_t) length;
+  for (point = path; point != NULL; point = point->next)
+    store->buffer[store->nb_buffered++] = (uint32_t) point->arc->id;
+  store->nb_paths++;
+
+  if (store->memory_limit != 0 && store->nb_buffered * sizeof(uint32_t) > store->memory_limit)
+    ciss_path_store_spill(store);
+}
+
+// Switches the store to reading, spilled records are mapped rather than read
+// back into the buffer.
+static void ciss_path_store_rewind(ciss_path_store* store) {
+  store->reading = 1;
+  store->records = store->buffer;
+  store->nb_records = store->nb_buffered;
+  if (store->failed || store->spill == NULL)
+    return;
+
+  if (!ciss_path_store_spill(store))
+    return;
+  if (fflush(store->spill) != 0) {
+    fprintf(stderr, "[ciss] could not write the path spill file\n");
+    store->failed = 1;
+    return;
+  }
+  store->mapping_size = store->nb_spilled * sizeof(uint32_t);
+  store->mapping = mmap(NULL, store->mapping_size, PROT_READ, MAP_PRIVATE, fileno(store->spill), 0);
+  if (store->mapping == MAP_FAILED) {
+    fprintf(stderr, "[ciss] could not map the path spill file\n");
+    store->mapping = NULL;
+    store->failed = 1;
+    return;
+  }
+  posix_madvise(store->mapping, store->mapping_size, POSIX_MADV_SEQUENTIAL);
+  store->records = (const uint32_t*) store->mapping;
+  store->nb_records = store->nb_spilled;
+  free(store->buffer);
+  store->buffer = NULL;
+  store->buffer_capacity = 0;
+}
+
+// Returns the next path in the order of appending, NULL after the last one or
+// if the store failed.  Nothing may be appended once reading started.  The
+// path is owned by the store and valid until the next call.
+ciss_graph_path* ciss_path_store_next(ciss_path_store* store) {
+  size_t length, i;
+
+  if (!store->reading)
+    ciss_path_store_rewind(store);
+  if (store->failed || store->position >= store->nb_records)
+    return NULL;
+
+  // Path-unique paths use every arc at most once.
+  length = store->records[store->position++];
+  if (length == 0 || length > store->nb_arcs || length > store->nb_records - store->position) {
+    fprintf(stderr, "[ciss] corrupted path record\n");
+    store->failed = 1;
+    return NULL;
+  }
+  if (length > store->nb_points) {
+    store->nb_points = length;
+    store->points = (ciss_graph_path_point*) realloc(store->points, sizeof(ciss_graph_path_point) * length);
+  }
+  for (i = 0; i < length; i++) {
+    uint32_t id = store->records[store->position++];
+    if (id >= store->nb_arcs || store->arcs[id] == NULL) {
+      fprintf(stderr, "[ciss] corrupted path record\n");
+      store->failed = 1;
+      return NULL;
+    }
+    store->points[i].arc = store->arcs[id];
+    store->points[i].next = i + 1 < length ? &store->points[i + 1] : NULL;
+  }
+  return store->points;
+}
@@ -0,0 +1,44 @@
+#ifndef PATHSTORE_H
+#define PATHSTORE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+#include "path.h"
+
+// Paths stored as records of arc identifiers, a length followed by the
+// identifiers.  Records are buffered in memory; once the buffer exceeds the
+// memory limit it is spilled to an unnamed temporary file, which is mapped
+// back and read sequentially.  A failed write or mapping marks the store as
+// failed, its paths are then incomplete.  Store has ownership of the buffer, of the file
+// and of the path it returns, but not of the arcs.
+typedef struct ciss_path_store {
+  ciss_graph_arc** arcs;  // By identifier.
+  size_t nb_arcs;
+  size_t memory_limit;    // Buffered bytes before spilling, never spills if 0.
+  uint32_t* buffer;
+  size_t nb_buffered;     // Words.
+  size_t buffer_capacity;
+  FILE* spill;            // NULL until the first spill.
+  size_t nb_spilled;      // Words.
+  size_t nb_paths;
+  int failed;
+  int reading;
+  const uint32_t* records;  // Records being read.
+  size_t nb_records;        // Words.
+  size_t position;
+  void* mapping;
+  size_t mapping_size;
+  ciss_graph_path_point* points;  // Last path read, reused by the next one.
+  size_t nb_points;
+} ciss_path_store;
+
+ciss_path_store* ciss_path_store_create(ciss_graph*, size_t memory_limit);
+void ciss_path_store_destroy(ciss_path_store*);
+
+void ciss_path_store_append(ciss_path_store*, ciss_graph_path*);
+ciss_graph_path* ciss_path_store_next(ciss_path_store*);
+
+#endif // PATHSTORE_H
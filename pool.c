@@ -0,0 +1,124 @@
+#include "pool.h"
+
+//+/////////////// tasks
+void ciss_task_init(ciss_task* task, void (*run)(ciss_task*, isl_ctx*), void* data) {
+  task->run = run;
+  task->data = data;
+  task->nb_pending = 0;
+  task->dependents = NULL;
+  task->nb_dependents = 0;
+  task->next = NULL;
+}
+
+void ciss_task_clear(ciss_task* task) {
+  free(task->dependents);
+  task->dependents = NULL;
+  task->nb_dependents = 0;
+}
+
+// Task will not run before the dependency finished.  Both must be submitted
+// to the same ciss_pool_run call.
+void ciss_task_depends(ciss_task* task, ciss_task* dependency) {
+  dependency->dependents = (ciss_task**) realloc(dependency->dependents,
+                                                 sizeof(ciss_task*) * (dependency->nb_dependents + 1));
+  dependency->dependents[dependency->nb_dependents++] = task;
+  task->nb_pending++;
+}
+
+//+/////////////// pool
+static void* ciss_pool_worker_main(void* arg) {
+  ciss_pool_worker* worker = (ciss_pool_worker*) arg;
+  ciss_pool* pool = worker->pool;
+  ciss_task* task;
+  size_t i;
+
+  pthread_mutex_lock(&pool->mutex);
+  for (;;) {
+    while (pool->ready == NULL && !pool->shutdown)
+      pthread_cond_wait(&pool->ready_cond, &pool->mutex);
+    if (pool->ready == NULL)
+      break;
+
+    task = pool->ready;
+    pool->ready = task->next;
+    pthread_mutex_unlock(&pool->mutex);
+    task->run(task, worker->ctx);
+    pthread_mutex_lock(&pool->mutex);
+
+    for (i = 0; i < task->nb_dependents; i++) {
+      ciss_task* dependent = task->dependents[i];
+      if (--dependent->nb_pending == 0) {
+        dependent->next = pool->ready;
+        pool->ready = dependent;
+        pthread_cond_signal(&pool->ready_cond);
+      }
+    }
+    if (--pool->nb_unfinished == 0)
+      pthread_cond_broadcast(&pool->done_cond);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+ciss_pool* ciss_pool_create(size_t nb_workers) {
+  ciss_pool* pool = (ciss_pool*) malloc(sizeof(ciss_pool));
+  size_t i;
+
+  pool->nb_workers = nb_workers;
+  pool->workers = (ciss_pool_worker*) malloc(sizeof(ciss_pool_worker) * nb_workers);
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->ready_cond, NULL);
+  pthread_cond_init(&pool->done_cond, NULL);
+  pool->ready = NULL;
+  pool->nb_unfinished = 0;
+  pool->shutdown = 0;
+
+  for (i = 0; i < nb_workers; i++) {
+    pool->workers[i].pool = pool;
+    pool->workers[i].ctx = isl_ctx_alloc();
+    pthread_create(&pool->workers[i].thread, NULL, ciss_pool_worker_main, &pool->workers[i]);
+  }
+  return pool;
+}
+
+void ciss_pool_destroy(ciss_pool* pool) {
+  size_t i;
+  if (pool == NULL)
+    return;
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->shutdown = 1;
+  pthread_cond_broadcast(&pool->ready_cond);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (i = 0; i < pool->nb_workers; i++) {
+    pthread_join(pool->workers[i].thread, NULL);
+    isl_ctx_free(pool->workers[i].ctx);
+  }
+  pthread_cond_destroy(&pool->done_cond);
+  pthread_cond_destroy(&pool->ready_cond);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->workers);
+  free(pool);
+}
+
+// Runs the tasks respecting their dependencies and waits for all of them.
+// Dependencies must not form a cycle.
+void ciss_pool_run(ciss_pool* pool, ciss_task** tasks, size_t nb_tasks) {
+  size_t i;
+  if (nb_tasks == 0)
+    return;
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->nb_unfinished += nb_tasks;
+  for (i = 0; i < nb_tasks; i++) {
+    if (tasks[i]->nb_pending == 0) {
+      tasks[i]->next = pool->ready;
+      pool->ready = tasks[i];
+    }
+  }
+  pthread_cond_broadcast(&pool->ready_cond);
+  while (pool->nb_unfinished != 0)
+    pthread_cond_wait(&pool->done_cond, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,52 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <isl/ctx.h>
+
+// Task runs once all the tasks it depends on have finished, on a worker
+// thread and with the isl context of that worker.  Task has ownership of its
+// dependent list, but not of the dependent tasks nor of the data.
+typedef struct ciss_task {
+  void (*run)(struct ciss_task*, isl_ctx*);
+  void* data;
+  size_t nb_pending;  // Dependencies that have not finished yet.
+  struct ciss_task** dependents;
+  size_t nb_dependents;
+  struct ciss_task* next;  // Ready queue.
+} ciss_task;
+
+struct ciss_pool;
+
+typedef struct ciss_pool_worker {
+  struct ciss_pool* pool;
+  pthread_t thread;
+  isl_ctx* ctx;
+} ciss_pool_worker;
+
+// Pool has ownership of the workers and of their isl contexts, but not of the
+// tasks.  Objects of different worker contexts must never be mixed.
+typedef struct ciss_pool {
+  size_t nb_workers;
+  ciss_pool_worker* workers;
+  pthread_mutex_t mutex;
+  pthread_cond_t ready_cond;  // Tasks became ready or the pool shuts down.
+  pthread_cond_t done_cond;   // All submitted tasks finished.
+  ciss_task* ready;
+  size_t nb_unfinished;
+  int shutdown;
+} ciss_pool;
+
+//+/// task-related functions
+void ciss_task_init(ciss_task*, void (*)(ciss_task*, isl_ctx*), void*);
+void ciss_task_clear(ciss_task*);
+void ciss_task_depends(ciss_task*, ciss_task*);
+
+//+/// pool-related functions
+ciss_pool* ciss_pool_create(size_t nb_workers);
+void ciss_pool_destroy(ciss_pool*);
+void ciss_pool_run(ciss_pool*, ciss_task**, size_t);
+
+#endif // POOL_H
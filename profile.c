@@ -0,0 +1,32 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "profile.h"
+
+#include <sys/resource.h>
+#include <time.h>
+
+void ciss_profile_init(ciss_profile* profile) {
+  profile->analysis = 0;
+  profile->paths = 0;
+  profile->splitting = 0;
+}
+
+void ciss_profile_print(FILE* file, ciss_profile* profile) {
+  fprintf(file, "[ciss] time: analysis %.6f s, paths %.6f s, splitting %.6f s, peak memory %ld kB\n",
+          profile->analysis, profile->paths, profile->splitting, ciss_profile_peak_memory());
+}
+
+// Monotonic time in seconds.
+double ciss_profile_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + 1e-9 * (double) ts.tv_nsec;
+}
+
+// Peak resident set size of the process in kB, as reported by getrusage.
+long ciss_profile_peak_memory(void) {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+  return usage.ru_maxrss;
+}
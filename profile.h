@@ -0,0 +1,19 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+
+// Wall-clock time spent in the phases of one analysis, in seconds.
+typedef struct ciss_profile {
+  double analysis;   // Dependence analysis, graph and reachability.
+  double paths;      // Path enumeration or path expression construction.
+  double splitting;  // Relation composition and domain splitting.
+} ciss_profile;
+
+void ciss_profile_init(ciss_profile*);
+void ciss_profile_print(FILE*, ciss_profile*);
+
+double ciss_profile_time(void);
+long ciss_profile_peak_memory(void);
+
+#endif // PROFILE_H
@@ -0,0 +1,101 @@
+#include "reach.h"
+
+#include <string.h>
+
+// row |= other, one word at a time.  The compiler vectorizes the loop for the
+// target architecture, rows may be the same.
+static void ciss_reachability_row_or(uint64_t* row, const uint64_t* other, size_t nb_words) {
+  size_t w;
+  for (w = 0; w < nb_words; w++) {
+    row[w] |= other[w];
+  }
+}
+
+ciss_reachability* ciss_reachability_create(ciss_graph* graph) {
+  ciss_reachability* reach = (ciss_reachability*) malloc(sizeof(ciss_reachability));
+  ciss_graph_node* node;
+  ciss_graph_arc* arc;
+  size_t i, k, n;
+  int max_label = 0;
+
+  n = ciss_graph_node_number(graph);
+  reach->nb_nodes = n;
+  reach->nb_words = (n + 63) / 64;
+  reach->nodes = (ciss_graph_node**) malloc(sizeof(ciss_graph_node*) * (n + 1));
+  for (i = 0, node = graph->nodes; node != NULL; i++, node = node->next) {
+    reach->nodes[i] = node;
+    if (node->label > max_label)
+      max_label = node->label;
+  }
+  reach->by_label = (size_t*) malloc(sizeof(size_t) * (max_label + 1));
+  for (i = 0; i < n; i++) {
+    reach->by_label[reach->nodes[i]->label] = i;
+  }
+
+  reach->rows = (uint64_t*) calloc(n * reach->nb_words + 1, sizeof(uint64_t));
+  for (i = 0; i < n; i++) {
+    for (arc = reach->nodes[i]->outgoing; arc != NULL; arc = arc->next) {
+      ciss_reachability_set_insert(ciss_reachability_row(reach, i),
+                                   ciss_reachability_index(reach, arc->target));
+    }
+  }
+
+  // Warshall's algorithm with word-wide row unions.
+  for (k = 0; k < n; k++) {
+    uint64_t* row_k = ciss_reachability_row(reach, k);
+    for (i = 0; i < n; i++) {
+      uint64_t* row_i = ciss_reachability_row(reach, i);
+      if (ciss_reachability_set_contains(row_i, k))
+        ciss_reachability_row_or(row_i, row_k, reach->nb_words);
+    }
+  }
+  return reach;
+}
+
+void ciss_reachability_destroy(ciss_reachability* reach) {
+  if (reach == NULL)
+    return;
+  free(reach->rows);
+  free(reach->nodes);
+  free(reach->by_label);
+  free(reach);
+}
+
+size_t ciss_reachability_index(ciss_reachability* reach, ciss_graph_node* node) {
+  return reach->by_label[node->label];
+}
+
+uint64_t* ciss_reachability_row(ciss_reachability* reach, size_t i) {
+  return &reach->rows[i * reach->nb_words];
+}
+
+int ciss_reachability_reaches(ciss_reachability* reach,
+                              ciss_graph_node* source,
+                              ciss_graph_node* target) {
+  return ciss_reachability_set_contains(
+      ciss_reachability_row(reach, ciss_reachability_index(reach, source)),
+      ciss_reachability_index(reach, target));
+}
+
+uint64_t* ciss_reachability_set_create(ciss_reachability* reach) {
+  return (uint64_t*) calloc(reach->nb_words + 1, sizeof(uint64_t));
+}
+
+int ciss_reachability_set_contains(const uint64_t* set, size_t i) {
+  return (set[i / 64] >> (i % 64)) & 1;
+}
+
+void ciss_reachability_set_insert(uint64_t* set, size_t i) {
+  set[i / 64] |= (uint64_t) 1 << (i % 64);
+}
+
+// Checks if node i reaches any node of the set.
+int ciss_reachability_row_intersects(ciss_reachability* reach, size_t i, const uint64_t* set) {
+  const uint64_t* row = ciss_reachability_row(reach, i);
+  uint64_t any = 0;
+  size_t w;
+  for (w = 0; w < reach->nb_words; w++) {
+    any |= row[w] & set[w];
+  }
+  return any != 0;
+}
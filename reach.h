@@ -0,0 +1,33 @@
+#ifndef REACH_H
+#define REACH_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "graph.h"
+
+// Reachability matrix packed in 64-bit words, row i holds the nodes reachable
+// from node i by a non-empty path.  Nodes are indexed in linked-list order.
+// Does not have ownership of the graph nodes.
+typedef struct ciss_reachability {
+  size_t nb_nodes;
+  size_t nb_words;
+  uint64_t* rows;
+  struct ciss_graph_node** nodes;
+  size_t* by_label;
+} ciss_reachability;
+
+ciss_reachability* ciss_reachability_create(ciss_graph*);
+void ciss_reachability_destroy(ciss_reachability*);
+
+size_t ciss_reachability_index(ciss_reachability*, ciss_graph_node*);
+uint64_t* ciss_reachability_row(ciss_reachability*, size_t);
+int ciss_reachability_reaches(ciss_reachability*, ciss_graph_node*, ciss_graph_node*);
+
+//+/// node sets in the same packed format, nb_words long
+uint64_t* ciss_reachability_set_create(ciss_reachability*);
+int ciss_reachability_set_contains(const uint64_t*, size_t);
+void ciss_reachability_set_insert(uint64_t*, size_t);
+int ciss_reachability_row_intersects(ciss_reachability*, size_t, const uint64_t*);
+
+#endif // REACH_H
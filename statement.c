@@ -0,0 +1,114 @@
+#include <candl/candl.h>
+
+#include <string.h>
+
+#include "convert.h"
+#include "statement.h"
+
+// Candl labels must have been set up by candl_scop_usr_init.  Domain sets are
+// restricted to the parameter context unless it is NULL.
+ciss_statement_index* ciss_statement_index_create(isl_ctx* ctx, osl_scop_p scop, isl_set* context) {
+  ciss_statement_index* index = (ciss_statement_index*) malloc(sizeof(ciss_statement_index));
+  osl_statement_p stmt;
+  candl_statement_usr_p stmt_usr;
+  int max_label = -1;
+  size_t i;
+
+  for (stmt = scop->statement; stmt != NULL; stmt = stmt->next) {
+    stmt_usr = (candl_statement_usr_p) stmt->usr;
+    if (stmt_usr->label > max_label)
+      max_label = stmt_usr->label;
+  }
+
+  index->nb_statements = max_label + 1;
+  index->statements = (ciss_statement*) malloc(sizeof(ciss_statement) * (index->nb_statements + 1));
+  for (i = 0; i < index->nb_statements; i++) {
+    index->statements[i].label = (int) i;
+    index->statements[i].original_domain = NULL;
+    index->statements[i].domain = NULL;
+    index->statements[i].domain_set = NULL;
+    index->statements[i].stmt_ptr = NULL;
+    index->statements[i].nb_images = 0;
+    index->statements[i].image_hashes = NULL;
+    index->statements[i].images = NULL;
+    index->statements[i].nb_splits = 0;
+    index->statements[i].nb_skipped = 0;
+    index->statements[i].nb_rejected = 0;
+  }
+
+  for (stmt = scop->statement; stmt != NULL; stmt = stmt->next) {
+    stmt_usr = (candl_statement_usr_p) stmt->usr;
+    ciss_statement* record = &index->statements[stmt_usr->label];
+    record->original_domain = stmt->domain;
+    record->domain = osl_relation_clone(stmt->domain);
+    record->domain_set = osl_relation_to_isl_set(ctx, stmt->domain);
+    if (context != NULL)
+      record->domain_set = isl_set_coalesce(isl_set_intersect_params(record->domain_set,
+                                                                     isl_set_copy(context)));
+    record->stmt_ptr = stmt;
+  }
+  return index;
+}
+
+void ciss_statement_index_destroy(ciss_statement_index* index) {
+  size_t i, j;
+  if (index == NULL)
+    return;
+  for (i = 0; i < index->nb_statements; i++) {
+    ciss_statement* record = &index->statements[i];
+    osl_relation_free(record->domain);
+    isl_set_free(record->domain_set);
+    for (j = 0; j < record->nb_images; j++) {
+      free(record->images[j]);
+    }
+    free(record->images);
+    free(record->image_hashes);
+  }
+  free(index->statements);
+  free(index);
+}
+
+ciss_statement* ciss_statement_index_find(ciss_statement_index* index, int label) {
+  if (label < 0 || (size_t) label >= index->nb_statements ||
+      index->statements[label].stmt_ptr == NULL)
+    return NULL;
+  return &index->statements[label];
+}
+
+// FNV-1a.
+static uint64_t ciss_statement_hash(const char* str) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (; *str != '\0'; str++) {
+    hash ^= (unsigned char) *str;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Checks whether the image was already used to split the domain.  Images are
+// compared by their textual form, which catches most repeated images once they
+// are coalesced, but not all equal ones.
+int ciss_statement_has_image(ciss_statement* record, isl_union_set* image) {
+  char* str = isl_union_set_to_str(image);
+  uint64_t hash = ciss_statement_hash(str);
+  size_t i;
+
+  for (i = 0; i < record->nb_images; i++) {
+    if (record->image_hashes[i] == hash && strcmp(record->images[i], str) == 0) {
+      free(str);
+      return 1;
+    }
+  }
+  free(str);
+  return 0;
+}
+
+// Remembers the image used to split the domain.
+void ciss_statement_add_image(ciss_statement* record, isl_union_set* image) {
+  char* str = isl_union_set_to_str(image);
+  record->image_hashes = (uint64_t*) realloc(record->image_hashes, sizeof(uint64_t) * (record->nb_images + 1));
+  record->images = (char**) realloc(record->images, sizeof(char*) * (record->nb_images + 1));
+  record->image_hashes[record->nb_images] = ciss_statement_hash(str);
+  record->images[record->nb_images] = str;
+  record->nb_images++;
+}
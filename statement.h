@@ -0,0 +1,45 @@
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <osl/osl.h>
+
+#include <isl/ctx.h>
+#include <isl/set.h>
+#include <isl/union_set.h>
+
+// Statement record has ownership of the split domain, of the cached isl set and
+// of the images, but not of the original domain and of the statement.
+typedef struct ciss_statement {
+  int label;
+  osl_relation_p original_domain;
+  osl_relation_p domain;
+  isl_set* domain_set;
+  osl_statement_p stmt_ptr;
+
+  // Images that already split the domain, in isl textual form.
+  size_t nb_images;
+  uint64_t* image_hashes;
+  char** images;
+  size_t nb_splits;   // Splits applied to the domain.
+  size_t nb_skipped;  // Splits that would have left the domain unchanged.
+  size_t nb_rejected; // Splits that would have left a too small chunk.
+} ciss_statement;
+
+// Statements indexed by their Candl label, labels without a statement have
+// a NULL stmt_ptr.
+typedef struct ciss_statement_index {
+  size_t nb_statements;
+  ciss_statement* statements;
+} ciss_statement_index;
+
+ciss_statement_index* ciss_statement_index_create(isl_ctx*, osl_scop_p, __isl_keep isl_set*);
+void ciss_statement_index_destroy(ciss_statement_index*);
+ciss_statement* ciss_statement_index_find(ciss_statement_index*, int);
+
+int ciss_statement_has_image(ciss_statement*, __isl_keep isl_union_set*);
+void ciss_statement_add_image(ciss_statement*, __isl_keep isl_union_set*);
+
+#endif // STATEMENT_H
@@ -1,17 +1,54 @@
 #include "../convert.h"
 
-int main() {
-  osl_scop_p scop = osl_scop_read(stdin);
-  isl_ctx* ctx = isl_ctx_alloc();
-//  osl_dependence_p dependence = (osl_dependence_p) osl_generic_lookup(scop->extension, OSL_URI_DEPENDENCE);
-  isl_union_map* umap = osl_relation_to_isl_union_map(ctx, scop->statement->scattering);
-  isl_printer* prn = isl_printer_to_file(ctx, stdout);
-  prn = isl_printer_print_union_map(prn, umap);
-  prn = isl_printer_print_str(prn, "\n");
-  osl_relation_p relation = isl_union_map_to_osl_relation(umap);
-  osl_relation_print(stdout, relation);
-  prn = isl_printer_flush(prn);
+// Converts the relations of the statements to isl and back, prints them and
+// fails if the round trip changes any of them.  Reads the scop from the file
+// given as argument, or from the standard input.
+static int check_round_trip(isl_ctx* ctx, isl_printer** prn, osl_relation_p relation) {
+  isl_union_map* umap = osl_relation_to_isl_union_map(ctx, relation);
+  osl_relation_p converted = isl_union_map_to_osl_relation(isl_union_map_copy(umap));
+  isl_union_map* round_trip = osl_relation_to_isl_union_map(ctx, converted);
+  int equal = isl_union_map_is_equal(umap, round_trip) == 1;
+
+  *prn = isl_printer_print_union_map(*prn, umap);
+  *prn = isl_printer_print_str(*prn, "\n");
+  *prn = isl_printer_flush(*prn);
+  osl_relation_print(stdout, converted);
+  if (!equal)
+    fprintf(stderr, "Round trip through OpenScop changed the relation\n");
+
+  osl_relation_free(converted);
+  isl_union_map_free(round_trip);
+  isl_union_map_free(umap);
+  return equal;
+}
+
+int main(int argc, char** argv) {
+  FILE* input = argc > 1 ? fopen(argv[1], "r") : stdin;
+  osl_scop_p scop;
+  osl_statement_p stmt;
+  isl_ctx* ctx;
+  isl_printer* prn;
+  int ok = 1;
+
+  if (input == NULL) {
+    fprintf(stderr, "Could not open %s\n", argv[1]);
+    return 1;
+  }
+  scop = osl_scop_read(input);
+  if (input != stdin)
+    fclose(input);
+  if (scop == NULL)
+    return 1;
+
+  ctx = isl_ctx_alloc();
+  prn = isl_printer_to_file(ctx, stdout);
+  for (stmt = scop->statement; stmt != NULL; stmt = stmt->next) {
+    ok = check_round_trip(ctx, &prn, stmt->domain) && ok;
+    if (stmt->scattering != NULL)
+      ok = check_round_trip(ctx, &prn, stmt->scattering) && ok;
+  }
   isl_printer_free(prn);
   isl_ctx_free(ctx);
-  return 0;
+  osl_scop_free(scop);
+  return ok ? 0 : 1;
 }
@@ -0,0 +1,117 @@
+# Runs ciss on one kernel, compares the split domains with the golden output
+# and the running time and peak memory with the stored baselines.
+#
+#   cmake -DCISS=<ciss> -DKERNEL=<kernel.scop> -DGOLDEN=<prefix>
+#         [-DREFERENCE=<prefix>] [-DOPTIONS=<ciss options>] [-DEXPECT=<regex>]
+#         [-DMARGIN=<percent>] [-DSLACK=<microseconds>]
+#         [-DMEMORY_MARGIN=<percent>] [-DMEMORY_SLACK=<kB>] [-DSTATE=<file>]
+#         -P regression.cmake
+#
+# Golden output is <reference>.out, baseline is <prefix>.time.  The reference
+# defaults to the prefix; modes that must reproduce the output of another mode
+# point it there.  With the CISS_UPDATE_GOLDEN environment variable set, the
+# baseline and the output of the reference itself are written instead of
+# compared.  Without a golden output the test reports it and is skipped.  The
+# statistics must match the expected regular expression, if any.  With a state
+# file, ciss first runs once to save its analysis there, the checks apply to
+# the second run that reuses it.
+
+if(NOT MARGIN)
+  set(MARGIN 50)
+endif()
+if(NOT SLACK)
+  set(SLACK 50000)
+endif()
+if(NOT MEMORY_MARGIN)
+  set(MEMORY_MARGIN 50)
+endif()
+if(NOT MEMORY_SLACK)
+  set(MEMORY_SLACK 4096)
+endif()
+if(NOT REFERENCE)
+  set(REFERENCE ${GOLDEN})
+endif()
+separate_arguments(OPTIONS)
+
+if(STATE)
+  file(REMOVE ${STATE})
+  list(APPEND OPTIONS -state ${STATE})
+  execute_process(COMMAND ${CISS} -all -stats ${OPTIONS}
+                  INPUT_FILE ${KERNEL}
+                  OUTPUT_QUIET
+                  ERROR_VARIABLE log
+                  RESULT_VARIABLE result)
+  if(NOT result EQUAL 0 OR NOT EXISTS ${STATE})
+    message(FATAL_ERROR "ciss failed to save its state (${result}):\n${log}")
+  endif()
+endif()
+
+execute_process(COMMAND ${CISS} -all -stats ${OPTIONS}
+                INPUT_FILE ${KERNEL}
+                OUTPUT_VARIABLE output
+                ERROR_VARIABLE log
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "ciss failed (${result}):\n${log}")
+endif()
+
+if(EXPECT AND NOT log MATCHES "${EXPECT}")
+  message(FATAL_ERROR "Statistics do not match \"${EXPECT}\":\n${log}")
+endif()
+
+# Phase times are printed with six decimals, turn them into microseconds.
+string(REGEX MATCH "time: analysis ([0-9.]+) s, paths ([0-9.]+) s, splitting ([0-9.]+) s, peak memory (-?[0-9]+) kB"
+       phases "${log}")
+if(NOT phases)
+  message(FATAL_ERROR "No timing in the statistics:\n${log}")
+endif()
+set(analysis ${CMAKE_MATCH_1})
+set(paths ${CMAKE_MATCH_2})
+set(splitting ${CMAKE_MATCH_3})
+set(memory ${CMAKE_MATCH_4})
+set(total 0)
+foreach(seconds ${analysis} ${paths} ${splitting})
+  string(REPLACE "." "" microseconds ${seconds})
+  string(REGEX REPLACE "^0*([0-9]+)$" "\\1" microseconds ${microseconds})
+  math(EXPR total "${total} + ${microseconds}")
+endforeach()
+message(STATUS "analysis ${analysis} s, paths ${paths} s, splitting ${splitting} s, "
+               "total ${total} us, peak memory ${memory} kB")
+
+if(DEFINED ENV{CISS_UPDATE_GOLDEN})
+  if(REFERENCE STREQUAL GOLDEN)
+    file(WRITE ${GOLDEN}.out "${output}")
+    message(STATUS "Updated ${GOLDEN}.out")
+  endif()
+  file(WRITE ${GOLDEN}.time "set(BASELINE_TIME ${total})\nset(BASELINE_MEMORY ${memory})\n")
+  message(STATUS "Updated ${GOLDEN}.time")
+  return()
+endif()
+
+if(NOT EXISTS ${REFERENCE}.out)
+  message(STATUS "Skipped: no golden output ${REFERENCE}.out, "
+                 "run the tests with CISS_UPDATE_GOLDEN set to record it")
+  return()
+endif()
+
+file(READ ${REFERENCE}.out golden)
+if(NOT output STREQUAL golden)
+  get_filename_component(name ${GOLDEN} NAME)
+  file(WRITE ${name}.actual "${output}")
+  message(FATAL_ERROR "Split domains differ from ${REFERENCE}.out, actual output in ${name}.actual")
+endif()
+
+if(EXISTS ${GOLDEN}.time)
+  include(${GOLDEN}.time)
+  math(EXPR limit "${BASELINE_TIME} * (100 + ${MARGIN}) / 100 + ${SLACK}")
+  if(total GREATER limit)
+    message(FATAL_ERROR "Took ${total} us, baseline ${BASELINE_TIME} us allows at most ${limit} us")
+  endif()
+  # Peak memory is negative where the platform does not report it.
+  if(DEFINED BASELINE_MEMORY AND NOT memory LESS 0 AND NOT BASELINE_MEMORY LESS 0)
+    math(EXPR limit "${BASELINE_MEMORY} * (100 + ${MEMORY_MARGIN}) / 100 + ${MEMORY_SLACK}")
+    if(memory GREATER limit)
+      message(FATAL_ERROR "Used ${memory} kB, baseline ${BASELINE_MEMORY} kB allows at most ${limit} kB")
+    endif()
+  endif()
+endif()
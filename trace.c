@@ -0,0 +1,122 @@
+#include "trace.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <isl/constraint.h>
+#include <isl/map.h>
+
+#include "profile.h"
+
+static FILE* ciss_trace_file = NULL;
+static double ciss_trace_origin = 0;
+static int ciss_trace_nb_events = 0;
+static unsigned ciss_trace_nb_threads = 0;
+static pthread_mutex_t ciss_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local unsigned ciss_trace_tid = 0;
+
+// Returns 0 if the file could not be opened.  Must not be called while spans
+// are being written.
+int ciss_trace_open(const char* filename) {
+  ciss_trace_close();
+  ciss_trace_file = fopen(filename, "w");
+  if (ciss_trace_file == NULL)
+    return 0;
+  ciss_trace_origin = ciss_profile_time();
+  ciss_trace_nb_events = 0;
+  fprintf(ciss_trace_file, "{\"traceEvents\": [\n");
+  return 1;
+}
+
+void ciss_trace_close(void) {
+  if (ciss_trace_file == NULL)
+    return;
+  fprintf(ciss_trace_file, "\n], \"displayTimeUnit\": \"ms\"}\n");
+  fclose(ciss_trace_file);
+  ciss_trace_file = NULL;
+}
+
+int ciss_trace_enabled(void) {
+  return ciss_trace_file != NULL;
+}
+
+// Start time of a span, 0 when not tracing.
+double ciss_trace_now(void) {
+  return ciss_trace_file != NULL ? ciss_profile_time() : 0;
+}
+
+static int ciss_trace_count_constraint(__isl_take isl_constraint* constraint, void* usr) {
+  (*(size_t*) usr)++;
+  isl_constraint_free(constraint);
+  return 0;
+}
+
+static int ciss_trace_count_basic_map(__isl_take isl_basic_map* bmap, void* usr) {
+  size_t* sizes = (size_t*) usr;
+  sizes[0]++;
+  isl_basic_map_foreach_constraint(bmap, &ciss_trace_count_constraint, &sizes[1]);
+  isl_basic_map_free(bmap);
+  return 0;
+}
+
+static int ciss_trace_count_map(__isl_take isl_map* map, void* usr) {
+  isl_map_foreach_basic_map(map, &ciss_trace_count_basic_map, usr);
+  isl_map_free(map);
+  return 0;
+}
+
+// Number of disjuncts and total number of constraints of the relation.
+void ciss_trace_relation_size(isl_union_map* umap, size_t* nb_disjuncts, size_t* nb_constraints) {
+  size_t sizes[2] = {0, 0};
+  if (umap != NULL)
+    isl_union_map_foreach_map(umap, &ciss_trace_count_map, sizes);
+  *nb_disjuncts = sizes[0];
+  *nb_constraints = sizes[1];
+}
+
+static void ciss_trace_write(const char* name, double start, isl_union_map* umap, int with_relation,
+                             const char* args, va_list ap) {
+  double end = ciss_profile_time();
+  size_t nb_disjuncts, nb_constraints;
+
+  if (with_relation)
+    ciss_trace_relation_size(umap, &nb_disjuncts, &nb_constraints);
+
+  pthread_mutex_lock(&ciss_trace_mutex);
+  if (ciss_trace_tid == 0)
+    ciss_trace_tid = ++ciss_trace_nb_threads;
+  fprintf(ciss_trace_file,
+          "%s{\"name\": \"%s\", \"cat\": \"ciss\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, "
+          "\"ts\": %.3f, \"dur\": %.3f, \"args\": {",
+          ciss_trace_nb_events++ == 0 ? "" : ",\n", name, ciss_trace_tid,
+          1e6 * (start - ciss_trace_origin), 1e6 * (end - start));
+  vfprintf(ciss_trace_file, args, ap);
+  if (with_relation) {
+    fprintf(ciss_trace_file, "%s\"disjuncts\": %zu, \"constraints\": %zu",
+            args[0] == '\0' ? "" : ", ", nb_disjuncts, nb_constraints);
+  }
+  fprintf(ciss_trace_file, "}}");
+  pthread_mutex_unlock(&ciss_trace_mutex);
+}
+
+// Complete event from start to now.
+void ciss_trace_span(const char* name, double start, const char* args, ...) {
+  va_list ap;
+  if (ciss_trace_file == NULL)
+    return;
+  va_start(ap, args);
+  ciss_trace_write(name, start, NULL, 0, args, ap);
+  va_end(ap);
+}
+
+// Same as above, annotated with the size of the relation.
+void ciss_trace_span_relation(const char* name, double start, isl_union_map* umap,
+                              const char* args, ...) {
+  va_list ap;
+  if (ciss_trace_file == NULL)
+    return;
+  va_start(ap, args);
+  ciss_trace_write(name, start, umap, 1, args, ap);
+  va_end(ap);
+}
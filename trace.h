@@ -0,0 +1,23 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdlib.h>
+
+#include <isl/union_map.h>
+
+// Chrome trace-event export, viewable in chrome://tracing or Perfetto.  The
+// tracer is global and does nothing unless a trace file is open, spans may be
+// written from any thread.  Span arguments are given as the printf-style
+// contents of a JSON object.
+int ciss_trace_open(const char*);
+void ciss_trace_close(void);
+int ciss_trace_enabled(void);
+
+double ciss_trace_now(void);
+void ciss_trace_span(const char* name, double start, const char* args, ...);
+void ciss_trace_span_relation(const char* name, double start, __isl_keep isl_union_map*,
+                              const char* args, ...);
+
+void ciss_trace_relation_size(__isl_keep isl_union_map*, size_t*, size_t*);
+
+#endif // TRACE_H